@@ -20,6 +20,7 @@
 """Module for a set of graphs.
 """
 
+from collections import deque
 from functools import partial
 import _graphillion
 from graphillion import setset
@@ -155,6 +156,9 @@ class GraphSet(object):
         """
         return GraphSet(self)
 
+    def __reduce__(self):
+        return (self.__class__, (self._ss,))
+
     def __nonzero__(self):
         return bool(self._ss)
 
@@ -464,6 +468,35 @@ class GraphSet(object):
 #    __idiv__ = quotient_update
 #    __imod__ = remainder_update
 
+    def lazy(self):
+        """Returns a lazily evaluated expression of `self`.
+
+        Set operations, |, &, -, ^, and ~, on the returned object are
+        not performed immediately but recorded as an expression.  The
+        expression is simplified and evaluated once when the result
+        is needed, e.g., by len(), iteration, or `in`.  Common
+        subexpressions are shared, and `(a & b) - c` and `(a | b) & c`
+        are computed in a single pass without intermediate
+        GraphSets.
+
+        Examples:
+          >>> graph1 = [(1, 2)]
+          >>> graph2 = [(1, 2), (1, 4)]
+          >>> graph3 = [(1, 4), (2, 3)]
+          >>> gs1 = GraphSet([graph1, graph2])
+          >>> gs2 = GraphSet([graph2, graph3])
+          >>> expr = (gs1.lazy() & gs2) - GraphSet([graph3])
+          >>> expr.evaluate()
+          GraphSet([[(1, 2), (1, 4)]])
+
+        Returns:
+          A lazy expression object, which evaluates to a GraphSet.
+
+        See Also:
+          union(), intersection(), difference(), symmetric_difference()
+        """
+        return self._ss.lazy(GraphSet)
+
     def isdisjoint(self, other):
         """Returns True if `self` has no graphs in common with `other`.
 
@@ -774,6 +807,40 @@ class GraphSet(object):
             return len([e for e in obj if e in self._ss]) > 0
         raise TypeError, obj
 
+    def contains(self, graphs):
+        """Returns a list of whether each graph is in `self` or not.
+
+        All the graphs are looked up in a single traversal of the
+        GraphSet, sharing the common edges among them, which is faster
+        than checking each graph with `in`.
+
+        Examples:
+          >>> graph1 = [(1, 2), (1, 4)]
+          >>> graph2 = [(2, 3)]
+          >>> gs = GraphSet([graph1, graph2])
+          >>> gs.contains([graph1, [(1, 2)], graph2])
+          [True, False, True]
+
+        Args:
+          graphs: A list of graphs (edge lists).
+
+        Returns:
+          A list of True or False in the same order as `graphs`.
+
+        Raises:
+          KeyError: If a given edge is not found in the universe.
+
+        See Also:
+          __contains__()
+        """
+        edges = []
+        for g in graphs:
+            type, obj = GraphSet._conv_arg(g)
+            if type != 'graph':
+                raise TypeError, g
+            edges.append(obj)
+        return self._ss.contains(edges)
+
     def add(self, graph_or_edge):
         """Adds a given graph or edge to `self`.
 
@@ -1065,7 +1132,7 @@ class GraphSet(object):
           A new GraphSet object.
 
         See Also:
-          larger(), graph_size()
+          larger(), graph_size(), weight_range()
         """
         return GraphSet(self._ss.smaller(size))
 
@@ -1089,7 +1156,7 @@ class GraphSet(object):
           A new GraphSet object.
 
         See Also:
-          smaller(), graph_size()
+          smaller(), graph_size(), weight_range()
         """
         return GraphSet(self._ss.larger(size))
 
@@ -1119,6 +1186,66 @@ class GraphSet(object):
         """
         return GraphSet(self._ss.set_size(size))
 
+    def graph_size_histogram(self):
+        """Returns the number of graphs for each number of edges.
+
+        The k-th item of the returned list is the number of graphs
+        with k edges in `self`, i.e., `gs.graph_size(k).len()`.  All
+        the numbers are counted in a single pass over the GraphSet.
+
+        Examples:
+          >>> graph1 = [(1, 2)]
+          >>> graph2 = [(1, 2), (1, 4)]
+          >>> graph3 = [(1, 4), (2, 3)]
+          >>> gs = GraphSet([graph1, graph2, graph3])
+          >>> gs.graph_size_histogram()
+          [0L, 1L, 2L]
+
+        Returns:
+          A list of the numbers of graphs, indexed by the number of
+          edges up to the largest graph.  An empty list if `self` is
+          empty.
+
+        See Also:
+          graph_size(), len()
+        """
+        return self._ss.size_histogram()
+
+    def weight_range(self, lower, upper, weights=None):
+        """Returns a new GraphSet with graphs whose total weight is in a range.
+
+        This method returns a new GraphSet with graphs that have the
+        sum of edge weights between `lower` and `upper`, inclusive.
+        The edge weights are specified by the argument or the universe
+        (1.0 if not specified).  The `self` is not changed.
+
+        Examples:
+          >>> graph1 = [(1, 2)]
+          >>> graph2 = [(1, 2), (1, 4)]
+          >>> graph3 = [(1, 2), (1, 4), (2, 3)]
+          >>> gs = GraphSet([graph1, graph2, graph3])
+          >>> weights = {(1, 2): 2.0, (1, 4): -3.0}  # (2, 3): 1.0
+          >>> gs.weight_range(-1.0, 0.0, weights)
+          GraphSet([[(1, 2), (1, 4)], [(1, 2), (1, 4), (2, 3)]])
+
+        Args:
+          lower: The lower bound of the total weight.
+
+          upper: The upper bound of the total weight.
+
+          weights: Optional.  A dictionary of edges to the weight
+            values.
+
+        Returns:
+          A new GraphSet object.
+
+        See Also:
+          smaller(), larger(), min_iter(), max_iter()
+        """
+        if weights is None:
+            weights = GraphSet._weights
+        return GraphSet(self._ss.weight_range(lower, upper, weights))
+
     def complement(self):
         """Returns a new GraphSet with complement graphs of `self`.
 
@@ -1462,12 +1589,15 @@ class GraphSet(object):
         """
         return self._ss.probability(probabilities)
 
-    def dump(self, fp):
+    def dump(self, fp, binary=None):
         """Serialize `self` to a file `fp`.
 
         This method does not serialize the universe, which should be
         saved separately by pickle.
 
+        A compact binary format is written if `fp` is opened in
+        binary mode, and a text format otherwise.  load() reads both.
+
         Examples:
           >>> import pickle
           >>> fp = open('/path/to/graphset', 'wb')
@@ -1478,12 +1608,15 @@ class GraphSet(object):
         Args:
           fp: A write-supporting file-like object.
 
+          binary: Optional.  True or False to choose the format
+            regardless of the mode of `fp`.
+
         See Also:
           dumps(), load()
         """
-        return self._ss.dump(fp)
+        return self._ss.dump(fp, binary)
 
-    def dumps(self):
+    def dumps(self, binary=False):
         """Returns a serialized `self`.
 
         This method does not serialize the universe, which should be
@@ -1494,10 +1627,14 @@ class GraphSet(object):
           >>> graphset_str = gs.dumps()
           >>> universe_str = pickle.dumps(GraphSet.universe())
 
+        Args:
+          binary: Optional.  If True, returns the compact binary
+            format instead of text.  loads() reads both.
+
         See Also:
           dump(), loads()
         """
-        return self._ss.dumps()
+        return self._ss.dumps(binary)
 
     @staticmethod
     def load(fp):
@@ -1557,10 +1694,15 @@ class GraphSet(object):
             edges to be processed in the internal graphset operations.
             The default is 'bfs', the breadth-first search from
             `source`.  Other options include 'dfs', the depth-first
-            search, and 'as-is', the order of `universe` list.
+            search, 'frontier', the order found by a heuristic search
+            that keeps the frontier small (see max_frontier_size()),
+            and 'as-is', the order of `universe` list.
 
           source: Optional.  This argument specifies the starting
             point of the edge traversal.
+
+        See Also:
+          max_frontier_size()
         """
         edges = []
         GraphSet._vertices = set()
@@ -1578,11 +1720,49 @@ class GraphSet(object):
                 for e in edges:
                     source = min(e[0], e[1], source)
             edges = GraphSet._traverse(edges, traversal, source)
+        elif traversal == 'frontier':
+            if source is not None:
+                if source not in set([u for e in edges for u in e]):
+                    raise KeyError, source
+                source = pickle.dumps(source)
+            graph = [(pickle.dumps(u), pickle.dumps(v)) for u, v in edges]
+            order = _graphillion._frontier_order(graph, 16, source)
+            edges = [edges[i] for i in order]
         for u, v in edges:
             GraphSet._vertices.add(u)
             GraphSet._vertices.add(v)
         setset.set_universe(edges)
 
+    @staticmethod
+    def max_frontier_size():
+        """Returns the largest frontier of the current universe.
+
+        Graphs are searched by scanning the edges of the universe in
+        order, keeping track of the vertices on the frontier between
+        the scanned and unscanned edges.  The time and memory to build
+        a GraphSet by graphs() and its variants grow exponentially with
+        the frontier size, which depends on the order of edges given
+        by `traversal` of set_universe().
+
+        Examples: a 9x9 grid graph
+          >>> GraphSet.set_universe(universe)
+          >>> GraphSet.max_frontier_size()
+          13
+          >>> GraphSet.set_universe(universe, traversal='frontier')
+          >>> GraphSet.max_frontier_size()
+          10
+
+        Returns:
+          The number of vertices on the largest frontier.
+
+        See Also:
+          set_universe()
+        """
+        graph = []
+        for e in setset.universe():
+            graph.append((pickle.dumps(e[0]), pickle.dumps(e[1])))
+        return _graphillion._max_frontier_size(graph)
+
     @staticmethod
     def universe():
         """Returns the current universe.
@@ -1651,7 +1831,12 @@ class GraphSet(object):
             instance, `linear_constraints=[([(1, 2, 0.6), (2, 5),
             (3, 6, 1.2)], (1.5, 2.0))]`, feasible graph weights are
             between 1.5 and 2.0, e.g., `[(1, 2), (2, 3), (3, 6)]` or
-            `[(1, 2), (2, 5), (5, 6)]`.
+            `[(1, 2), (2, 5), (5, 6)]`.  A constraint whose weights are
+            all decimals with up to six fractional digits, e.g., 0.6
+            and 1.2, is summed exactly as decimals, so that 0.1 + 0.2
+            meets an upper bound of 0.3.  Other constraints, e.g., with
+            a weight computed as 0.1 * 3, which is not the number
+            nearest to 0.3, are summed in floating point.
             See graphillion/test/graphset.py in detail.
 
         Returns:
@@ -1846,11 +2031,7 @@ class GraphSet(object):
         Returns:
           A new GraphSet object.
         """
-        dc = {}
-        for v in GraphSet._vertices:
-            dc[v] = 2 if is_hamilton else xrange(0, 3, 2)
-        return GraphSet.graphs(vertex_groups=[[]], degree_constraints=dc,
-                               graphset=graphset)
+        return GraphSet._paths(None, None, is_hamilton, graphset)
 
     @staticmethod
     def paths(terminal1, terminal2, is_hamilton=False, graphset=None):
@@ -1869,15 +2050,20 @@ class GraphSet(object):
         Returns:
           A new GraphSet object.
         """
-        dc = {}
-        for v in GraphSet._vertices:
-            if v in (terminal1, terminal2):
-                dc[v] = 1
-            else:
-                dc[v] = 2 if is_hamilton else xrange(0, 3, 2)
-        return GraphSet.graphs(vertex_groups=[[terminal1, terminal2]],
-                               degree_constraints=dc,
-                               no_loop=True, graphset=graphset)
+        if terminal1 == terminal2:
+            dc = {}
+            for v in GraphSet._vertices:
+                if v in (terminal1, terminal2):
+                    dc[v] = 1
+                else:
+                    dc[v] = 2 if is_hamilton else xrange(0, 3, 2)
+            return GraphSet.graphs(vertex_groups=[[terminal1, terminal2]],
+                                   degree_constraints=dc,
+                                   no_loop=True, graphset=graphset)
+        for v in (terminal1, terminal2):
+            if v not in GraphSet._vertices:
+                raise KeyError, v
+        return GraphSet._paths(terminal1, terminal2, is_hamilton, graphset)
 
     @staticmethod
     def show_messages(flag=True):
@@ -1893,6 +2079,162 @@ class GraphSet(object):
         """
         return _graphillion._show_messages(flag)
 
+    @staticmethod
+    def compact_states(flag=True):
+        """Enables/disables compact states in constructing GraphSets.
+
+        GraphSet.graphs(), GraphSet.paths(), GraphSet.cycles() and
+        other constructors of this kind keep intermediate states in
+        which each vertex on the frontier is packed into the minimum
+        number of bits.  It reduces the memory for the states, but
+        takes more than twice as long.  The results do not depend on
+        the setting.
+
+        Examples:
+          >>> GraphSet.compact_states()
+          False
+          >>> paths = GraphSet.paths(1, 6)
+
+        Args:
+          flag: Optional.  True or False.  If True, compact states are
+          enabled.  If False, they are disabled (initial setting).
+
+        Returns:
+          The setting before the method call.  True (enabled) or
+          False (disabled).
+        """
+        return _graphillion._compact_states(flag)
+
+    @staticmethod
+    def lookahead(depth=None):
+        """Sets the depth of lookahead in constructing GraphSets.
+
+        GraphSet.graphs(), GraphSet.paths(), GraphSet.cycles() and
+        other constructors of this kind generate intermediate states
+        edge by edge.  With lookahead, a state is dropped as soon as
+        it is found not to lead to any graph within `depth` edges,
+        and states in which no component can be completed any more
+        are dropped too.  It narrows the intermediate levels at the
+        cost of extra search.  The results do not depend on the
+        setting.
+
+        Examples:
+          >>> GraphSet.lookahead(2)
+          0
+          >>> paths = GraphSet.paths(1, 6)
+
+        Args:
+          depth: Optional.  A non-negative number.  0 disables
+            lookahead (initial setting).  If not given, the setting
+            is left unchanged.
+
+        Returns:
+          The setting before the method call.
+        """
+        if depth is None:
+            return _graphillion._lookahead()
+        if depth < 0:
+            raise ValueError, depth
+        return _graphillion._lookahead(depth)
+
+    @staticmethod
+    def spill_threshold(size=None):
+        """Sets the memory size for intermediate states in constructing GraphSets.
+
+        GraphSet.graphs(), GraphSet.paths(), GraphSet.cycles() and
+        other constructors of this kind keep intermediate states in
+        memory.  With a threshold, states beyond `size` bytes are
+        written to a temporary file, and equivalent states are merged
+        by sorting them.  It allows a construction with more states
+        than memory, but takes longer.  The results do not depend on
+        the setting.
+
+        Examples:
+          >>> GraphSet.spill_threshold(1 << 30)
+          0
+          >>> paths = GraphSet.paths(1, 6)
+
+        Args:
+          size: Optional.  A non-negative number in bytes.  0 keeps
+            all states in memory (initial setting).  If not given,
+            the setting is left unchanged.
+
+        Returns:
+          The setting before the method call.
+        """
+        if size is None:
+            return _graphillion._spill_threshold()
+        if size < 0:
+            raise ValueError, size
+        return _graphillion._spill_threshold(size)
+
+    @staticmethod
+    def construction_stats():
+        """Returns statistics of the last construction of a GraphSet.
+
+        It helps to see the effects of GraphSet.compact_states(),
+        GraphSet.lookahead(), GraphSet.spill_threshold() and
+        GraphSet.num_threads() on GraphSet.graphs(), GraphSet.paths(),
+        GraphSet.cycles() and other constructors of this kind.
+
+        Examples:
+          >>> paths = GraphSet.paths(1, 6)
+          >>> GraphSet.construction_stats()['spilled_size']
+          0
+
+        Returns:
+          A dict of 'num_nodes', the number of nodes before
+          reduction, 'state_size', the bytes of an intermediate
+          state, 'num_threads', the number of threads used,
+          'spilled_size', the bytes written to a temporary file, and
+          'merge_passes', the max number of passes in which states
+          of a level were merged from the file.
+        """
+        return _graphillion._construction_stats()
+
+    @staticmethod
+    def num_threads(num_threads=None):
+        """Sets the number of threads used to construct GraphSets.
+
+        GraphSet.graphs(), GraphSet.paths(), GraphSet.cycles() and
+        other constructors of this kind are executed in parallel if
+        Graphillion is built with OpenMP.  The results do not depend
+        on the number of threads.
+
+        Examples:
+          >>> GraphSet.num_threads(4)
+          1
+          >>> paths = GraphSet.paths(1, 6)
+
+        Args:
+          num_threads: Optional.  A positive number.  If not given,
+            the setting is left unchanged.
+
+        Returns:
+          The setting before the method call.  It is always 1 without
+          OpenMP.
+        """
+        if num_threads is None:
+            return _graphillion._num_threads()
+        if num_threads <= 0:
+            raise ValueError, num_threads
+        return _graphillion._num_threads(num_threads)
+
+    @staticmethod
+    def _paths(terminal1, terminal2, is_hamilton, graphset):
+        graph = []
+        for e in setset.universe():
+            assert e[0] in GraphSet._vertices and e[1] in GraphSet._vertices
+            graph.append((pickle.dumps(e[0]), pickle.dumps(e[1])))
+        if terminal1 is not None:
+            terminal1 = pickle.dumps(terminal1)
+            terminal2 = pickle.dumps(terminal2)
+        ss = None if graphset is None else graphset._ss
+        ss = _graphillion._paths(graph=graph, terminal1=terminal1,
+                                 terminal2=terminal2,
+                                 is_hamilton=is_hamilton, search_space=ss)
+        return GraphSet(ss)
+
     @staticmethod
     def _traverse(edges, traversal, source):
         neighbors = {}
@@ -1907,28 +2249,32 @@ class GraphSet(object):
                 neighbors[v].add(u)
         assert source in neighbors
         vertices = set(neighbors.keys())
+        edge_set = set(edges)
 
         sorted_edges = []
-        queue_or_stack = []
+        queue_or_stack = deque()
+        queued_vertices = set()
         visited_vertices = set()
         u = source
         while True:
             visited_vertices.add(u)
             for v in sorted(neighbors[u]):
                 if v in visited_vertices:
-                    e = (u, v) if (u, v) in edges else (v, u)
+                    e = (u, v) if (u, v) in edge_set else (v, u)
                     sorted_edges.append(e)
-            new_vertices = neighbors[u] - visited_vertices - set(queue_or_stack)
+            new_vertices = neighbors[u] - visited_vertices - queued_vertices
             queue_or_stack.extend(new_vertices)
+            queued_vertices.update(new_vertices)
             if not queue_or_stack:
                 if visited_vertices == vertices:
                     break
                 else:
                     queue_or_stack.append(min(vertices - visited_vertices))
             if traversal == 'bfs':
-                u, queue_or_stack = queue_or_stack[0], queue_or_stack[1:]
+                u = queue_or_stack.popleft()
             else:
-                queue_or_stack, u = queue_or_stack[:-1], queue_or_stack[-1]
+                u = queue_or_stack.pop()
+            queued_vertices.discard(u)
             assert u not in visited_vertices
         assert set(edges) == set(sorted_edges)
         return sorted_edges
@@ -96,6 +96,10 @@ class setset(_graphillion.setset):
         set_or_elem = setset._conv_arg(set_or_elem)
         return _graphillion.setset.__contains__(self, set_or_elem)
 
+    def contains(self, sets):
+        sets = [setset._conv_arg(s) for s in sets]
+        return _graphillion.setset.contains(self, sets)
+
     def add(self, set_or_elem):
         set_or_elem = setset._conv_arg(set_or_elem)
         return _graphillion.setset.add(self, set_or_elem)
@@ -134,15 +138,18 @@ class setset(_graphillion.setset):
         return self._optimize(weights, default, _graphillion.setset.max_iter)
 
     def _optimize(self, weights, default, generator):
-        ws = [default] * (_graphillion._num_elems() + 1)
-        if weights:
-            for e, w in weights.iteritems():
-                i = setset._obj2int[e]
-                ws[i] = w
+        ws = setset._conv_weights(weights, default)
         i = generator(self, ws)
         while (True):
             yield setset._conv_ret(i.next())
 
+    def weight_range(self, lower, upper, weights=None, default=1):
+        ws = setset._conv_weights(weights, default)
+        return _graphillion.setset.weight_range(self, ws, lower, upper)
+
+    def lazy(self, wrap=None):
+        return lazy(self, wrap)
+
     def supersets(self, obj):
         if (not isinstance(obj, setset)):
             obj = setset._conv_elem(obj)
@@ -165,13 +172,17 @@ class setset(_graphillion.setset):
         assert len([p for p in ps[1:] if p < 0 or 1 < p]) == 0
         return _graphillion.setset.probability(self, ps)
 
+    def __reduce__(self):
+        return (_unpickle, (self.__class__, setset.universe(),
+                            self.dumps(binary=True)))
+
     @staticmethod
     def load(fp):
-        return _graphillion.load(fp)
+        return setset(_graphillion.load(fp))
 
     @staticmethod
     def loads(s):
-        return _graphillion.loads(s)
+        return setset(_graphillion.loads(s))
 
     @staticmethod
     def set_universe(universe):
@@ -225,6 +236,15 @@ class setset(_graphillion.setset):
         else:  # an element
             return setset._conv_elem(obj)
 
+    @staticmethod
+    def _conv_weights(weights, default):
+        ws = [default] * (_graphillion._num_elems() + 1)
+        if weights:
+            for e, w in weights.iteritems():
+                i = setset._obj2int[e]
+                ws[i] = w
+        return ws
+
     @staticmethod
     def _conv_ret(obj):
         if isinstance(obj, (set, frozenset)):  # a set
@@ -236,3 +256,166 @@ class setset(_graphillion.setset):
 
     _obj2int = {}
     _int2obj = [None]
+
+
+def _unpickle(cls, universe, s):
+    if setset.universe() != universe:
+        raise ValueError, 'universe mismatch'
+    return cls(_graphillion.loads(s))
+
+
+class lazy(object):
+    """Represents a lazily evaluated expression of setset operations.
+
+    Operators on a lazy object, |, &, -, ^, and ~, only record the
+    expression as a DAG.  The expression is simplified when it is
+    built (e.g., `a - a` is empty and `~~a` is `a`), and common
+    subexpressions are evaluated once.  Patterns `(a & b) - c` and
+    `(a | b) & c` are fused into single-pass operations unless the
+    inner result is shared.  The expression is evaluated when the
+    result is consumed by len(), iteration, `in`, dump(), or
+    evaluate(), and the result is kept.  Other attributes are looked
+    up on the evaluated result.
+
+    Examples:
+      >>> from graphillion import setset
+      >>> a = setset([set([1]), set([1, 2])])
+      >>> b = setset([set([1, 2]), set([2])])
+      >>> e = (a.lazy() | b) & setset([set([1]), set([3])])
+      >>> len(e)
+      1
+    """
+
+    def __init__(self, obj, wrap=None):
+        lazy._init(self, 'leaf', (obj,), ('leaf', id(obj)), wrap)
+
+    def __or__(self, other):
+        return lazy._make('|', self, lazy._coerce(other))
+
+    def __and__(self, other):
+        return lazy._make('&', self, lazy._coerce(other))
+
+    def __sub__(self, other):
+        return lazy._make('-', self, lazy._coerce(other))
+
+    def __xor__(self, other):
+        return lazy._make('^', self, lazy._coerce(other))
+
+    def __invert__(self):
+        if self._op == '~':
+            return self._args[0]._rewrap(self._wrap)
+        return lazy._node('~', (self,), ('~', self._key), self._wrap)
+
+    def evaluate(self):
+        if self._result is None:
+            counts = {}
+            self._count(counts)
+            v = self._eval({}, counts)
+            self._result = self._wrap(v) if self._wrap else v
+        return self._result
+
+    def __len__(self):
+        return len(self.evaluate())
+
+    def __iter__(self):
+        return iter(self.evaluate())
+
+    def __contains__(self, obj):
+        return obj in self.evaluate()
+
+    def __nonzero__(self):
+        return bool(self.evaluate())
+
+    def __repr__(self):
+        return repr(self.evaluate())
+
+    def __getattr__(self, name):
+        return getattr(self.evaluate(), name)
+
+    @staticmethod
+    def _init(e, op, args, key, wrap):
+        e._op = op
+        e._args = args
+        e._key = key
+        e._wrap = wrap
+        e._result = None
+
+    @staticmethod
+    def _node(op, args, key, wrap):
+        e = object.__new__(lazy)
+        lazy._init(e, op, args, key, wrap)
+        return e
+
+    @staticmethod
+    def _coerce(obj):
+        if isinstance(obj, lazy):
+            return obj
+        elif isinstance(obj, _graphillion.setset):
+            return lazy(obj)
+        elif hasattr(obj, '_ss'):  # GraphSet
+            return lazy(obj._ss, obj.__class__)
+        raise TypeError, obj
+
+    @staticmethod
+    def _make(op, a, b):
+        wrap = a._wrap or b._wrap
+        if a._key == b._key:
+            if op in ('|', '&'):
+                return a._rewrap(wrap)
+            return lazy(setset(), wrap)
+        if b._is_empty():
+            return (b if op == '&' else a)._rewrap(wrap)
+        if a._is_empty():
+            return (a if op in ('&', '-') else b)._rewrap(wrap)
+        if op == '-':
+            key = (op, a._key, b._key)
+        else:  # commutative
+            key = (op,) + tuple(sorted([a._key, b._key]))
+        return lazy._node(op, (a, b), key, wrap)
+
+    def _rewrap(self, wrap):
+        if self._wrap is wrap:
+            return self
+        return lazy._node(self._op, self._args, self._key, wrap)
+
+    def _is_empty(self):
+        return self._op == 'leaf' and not self._args[0]
+
+    def _count(self, counts):
+        counts[self._key] = counts.get(self._key, 0) + 1
+        if counts[self._key] == 1 and self._op != 'leaf':
+            for e in self._args:
+                e._count(counts)
+
+    def _fusible(self, op, memo, counts):
+        return (self._op == op and self._key not in memo and
+                counts[self._key] == 1)
+
+    def _eval(self, memo, counts):
+        if self._key in memo:
+            return memo[self._key]
+        op, args = self._op, self._args
+        if op == 'leaf':
+            v = args[0]
+        elif op == '~':
+            v = ~args[0]._eval(memo, counts)
+        elif op == '-' and args[0]._fusible('&', memo, counts):
+            f, g = [e._eval(memo, counts) for e in args[0]._args]
+            v = f.intersection_difference(g, args[1]._eval(memo, counts))
+        elif op == '&' and (args[0]._fusible('|', memo, counts) or
+                            args[1]._fusible('|', memo, counts)):
+            u, h = args if args[0]._fusible('|', memo, counts) else args[::-1]
+            f, g = [e._eval(memo, counts) for e in u._args]
+            v = f.union_intersection(g, h._eval(memo, counts))
+        else:
+            f, g = [e._eval(memo, counts) for e in args]
+            if op == '|':
+                v = f | g
+            elif op == '&':
+                v = f & g
+            elif op == '-':
+                v = f - g
+            else:
+                v = f ^ g
+        memo[self._key] = v
+        return v
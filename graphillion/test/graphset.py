@@ -18,6 +18,7 @@
 # WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 from graphillion import GraphSet
+import pickle
 import tempfile
 import unittest
 
@@ -45,6 +46,17 @@ g234 = [e2, e3, e4]
 g1234 = [e1, e2, e3, e4]
 
 
+def grid(n):
+    """Returns the edges of an n x n grid, numbering vertices row by row."""
+    edges = []
+    for v in range(1, n * n + 1):
+        if v % n != 0:
+            edges.append((v, v + 1))
+        if v <= (n - 1) * n:
+            edges.append((v, v + n))
+    return edges
+
+
 class TestGraphSet(unittest.TestCase):
 
     def setUp(self):
@@ -237,6 +249,21 @@ class TestGraphSet(unittest.TestCase):
         self.assertEqual(len(gs), 1)
         self.assertTrue([(1, 4), (2, 3), (2, 5), (3, 6), (4, 5)] in gs)
 
+        # paths and cycles agree with the equivalent degree constraints
+        for is_hamilton in [False, True]:
+            dc = {}
+            for v in range(1, 7):
+                dc[v] = 2 if is_hamilton else xrange(0, 3, 2)
+            self.assertEqual(GraphSet.cycles(is_hamilton),
+                             GraphSet.graphs(vertex_groups=[[]],
+                                             degree_constraints=dc))
+            for u, w in [(1, 6), (1, 2), (5, 3), (4, 2)]:
+                pdc = dict(dc)
+                pdc[u] = pdc[w] = 1
+                gs = GraphSet.graphs(vertex_groups=[[u, w]],
+                                     degree_constraints=pdc, no_loop=True)
+                self.assertEqual(GraphSet.paths(u, w, is_hamilton), gs)
+
         # called as instance methods
         gs = GraphSet.graphs(no_loop=True)
         _ = gs.connected_components([1, 3, 5])
@@ -249,6 +276,33 @@ class TestGraphSet(unittest.TestCase):
         # exceptions
         self.assertRaises(KeyError, GraphSet.graphs, vertex_groups=[[7]])
         self.assertRaises(KeyError, GraphSet.graphs, degree_constraints={7: 1})
+        self.assertRaises(KeyError, GraphSet.paths, 1, 7)
+
+        # a loop has degree 2 and is a cycle on its own
+        for u in [[(1, 1), (1, 2), (2, 3), (3, 1)],
+                  [(1, 2), (2, 2), (2, 3), (3, 1)]]:
+            GraphSet.set_universe(u)
+            loop = [e for e in u if e[0] == e[1]]
+            self.assertEqual(GraphSet.cycles(),
+                             GraphSet([[(1, 2), (2, 3), (3, 1)], loop]))
+            self.assertEqual(GraphSet.cycles(is_hamilton=True),
+                             GraphSet([[(1, 2), (2, 3), (3, 1)]]))
+            for is_hamilton in [False, True]:
+                for v, w in [(1, 3), (1, 2), (2, 3)]:
+                    pdc = {}
+                    for x in range(1, 4):
+                        pdc[x] = 2 if is_hamilton else xrange(0, 3, 2)
+                    pdc[v] = pdc[w] = 1
+                    gs = GraphSet.graphs(vertex_groups=[[v, w]],
+                                         degree_constraints=pdc, no_loop=True)
+                    self.assertEqual(GraphSet.paths(v, w, is_hamilton), gs)
+        GraphSet.set_universe([(1, 2), (2, 3), (3, 3)])
+        self.assertEqual(GraphSet.cycles(), GraphSet([[(3, 3)]]))
+        self.assertEqual(GraphSet.cycles(is_hamilton=True), GraphSet())
+        self.assertEqual(GraphSet.paths(1, 2), GraphSet([[(1, 2)]]))
+        self.assertEqual(GraphSet.paths(1, 3), GraphSet([[(1, 2), (2, 3)]]))
+        self.assertEqual(GraphSet.paths(1, 3, is_hamilton=True),
+                         GraphSet([[(1, 2), (2, 3)]]))
 
     def test_linear_constraints(self):
         GraphSet.set_universe([(1, 2), (1, 4), (2, 3), (2, 5), (3, 6), (4, 5),
@@ -293,6 +347,40 @@ class TestGraphSet(unittest.TestCase):
                                                  ([(5, 6)], (1, 7))])
         self.assertEqual(len(gs), 2)
 
+        # integer and decimal weights are counted exactly, merging partial
+        # sums; the others fall back to floating point
+        universe = GraphSet.universe()
+        bounds = [(4, 20), (-5, 5), (1, 2), (-7, float("inf"))]
+        for scale in [2, 0.5, 0.1, 2 ** 0.5]:
+            decimal = scale != 2 ** 0.5
+            r = lambda x: round(x, 6) if decimal else x
+            weights = [(e[0], e[1], r(scale * w)) for e, w
+                       in zip(universe, [3, -6, 9, 12, -3, 6, 15])]
+            for lb, ub in bounds + ([(0, 0), (-3, 9)] if decimal else []):
+                lb, ub = r(scale * lb), r(scale * ub)
+                gs = GraphSet.graphs(linear_constraints=[(weights, (lb, ub))])
+                expected = 0
+                for g in GraphSet.graphs():
+                    s = sum(w for u, v, w in weights
+                            if (u, v) in g or (v, u) in g)
+                    if lb - 1e-9 <= s <= ub + 1e-9:
+                        expected += 1
+                self.assertEqual(len(gs), expected)
+
+        # decimals are summed as decimals, but 0.1 * 3 is not 0.3
+        gs = GraphSet.graphs(linear_constraints=[([(1, 2, 0.1), (1, 4, 0.2)],
+                                                  (0.3, 0.3))])
+        self.assertTrue([(1, 2), (1, 4)] in gs)
+        # each constraint is counted on its own, so a vacuous one in
+        # floating point changes nothing
+        self.assertEqual(
+            GraphSet.graphs(linear_constraints=[
+                ([(1, 2, 0.1), (1, 4, 0.2)], (0.3, 0.3)),
+                ([(2, 3, 2 ** 0.5)], (-1e9, 1e9))]), gs)
+        gs = GraphSet.graphs(linear_constraints=[([(1, 2, 0.1 * 3)],
+                                                  (0.3, 0.3))])
+        self.assertEqual(gs, GraphSet())
+
     def test_show_messages(self):
         a = GraphSet.show_messages()
         b = GraphSet.show_messages(True)
@@ -302,6 +390,115 @@ class TestGraphSet(unittest.TestCase):
         d = GraphSet.show_messages(a)
         self.assertFalse(d)
 
+    def test_num_threads(self):
+        GraphSet.set_universe(grid(5))
+
+        prev = GraphSet.num_threads()
+        self.assertTrue(prev >= 1)
+        results = []
+        for n in range(1, 5):
+            GraphSet.num_threads(n)
+            m = GraphSet.num_threads()  # always 1 without OpenMP
+            paths = GraphSet.paths(1, 25)
+            self.assertEqual(GraphSet.construction_stats()['num_threads'], m)
+            trees = GraphSet.trees(is_spanning=True)
+            self.assertEqual(GraphSet.construction_stats()['num_threads'], m)
+            short_paths = GraphSet.graphs(num_edges=range(0, 10),
+                                          graphset=paths)
+            self.assertEqual(GraphSet.construction_stats()['num_threads'], m)
+            self.assertEqual(len(paths), 8512)
+            self.assertEqual(len(trees), 557568000)
+            self.assertEqual(len(short_paths), 70)
+            results.append((paths, trees, short_paths))
+        for r in results[1:]:
+            self.assertEqual(r, results[0])
+        self.assertTrue(GraphSet.num_threads(prev) >= 1)
+        self.assertEqual(GraphSet.num_threads(), prev)
+        self.assertRaises(ValueError, GraphSet.num_threads, 0)
+
+    def test_compact_states(self):
+        GraphSet.set_universe(grid(5))
+
+        paths = GraphSet.paths(1, 25)
+        size = GraphSet.construction_stats()['state_size']
+        trees = GraphSet.trees(1, is_spanning=True)
+        tree_size = GraphSet.construction_stats()['state_size']
+        self.assertFalse(GraphSet.compact_states())
+        self.assertTrue(GraphSet.compact_states(True))
+        self.assertEqual(GraphSet.paths(1, 25), paths)
+        self.assertTrue(GraphSet.construction_stats()['state_size'] < size)
+        self.assertEqual(GraphSet.trees(1, is_spanning=True), trees)
+        self.assertTrue(
+            GraphSet.construction_stats()['state_size'] < tree_size)
+        self.assertEqual(len(paths), 8512)
+        self.assertTrue(GraphSet.compact_states(False))
+        self.assertFalse(GraphSet.compact_states(False))
+
+    def test_lookahead(self):
+        GraphSet.set_universe(grid(5))
+
+        self.assertEqual(GraphSet.lookahead(), 0)
+        results = []
+        nodes = []
+        for d in range(0, 4):
+            self.assertEqual(GraphSet.lookahead(d), max(d - 1, 0))
+            paths = GraphSet.paths(1, 25)
+            path_nodes = GraphSet.construction_stats()['num_nodes']
+            cycles = GraphSet.cycles()
+            cycle_nodes = GraphSet.construction_stats()['num_nodes']
+            trees = GraphSet.trees(1, is_spanning=True)
+            tree_nodes = GraphSet.construction_stats()['num_nodes']
+            self.assertEqual(len(paths), 8512)
+            self.assertEqual(len(cycles), 9349)
+            results.append((paths, cycles, trees))
+            nodes.append((path_nodes, cycle_nodes, tree_nodes))
+        for r in results[1:]:
+            self.assertEqual(r, results[0])
+        # dead states are pruned, and deeper lookahead never adds nodes
+        for k in range(3):
+            self.assertTrue(nodes[1][k] < nodes[0][k])
+            for d in range(1, 4):
+                self.assertTrue(nodes[d][k] <= nodes[d - 1][k])
+        self.assertEqual(GraphSet.lookahead(0), 3)
+        self.assertEqual(GraphSet.lookahead(), 0)
+        self.assertRaises(ValueError, GraphSet.lookahead, -1)
+
+    def test_spill_threshold(self):
+        GraphSet.set_universe(grid(5))
+
+        trees = GraphSet.trees(1, is_spanning=True)
+        self.assertEqual(GraphSet.construction_stats()['spilled_size'], 0)
+        self.assertEqual(GraphSet.spill_threshold(), 0)
+        self.assertEqual(GraphSet.spill_threshold(1), 0)
+        self.assertEqual(GraphSet.trees(1, is_spanning=True), trees)
+        stats = GraphSet.construction_stats()
+        self.assertTrue(stats['spilled_size'] > 0)
+        self.assertTrue(stats['merge_passes'] >= 1)
+        self.assertEqual(len(trees), 557568000)
+        self.assertEqual(GraphSet.spill_threshold(0), 1)
+        self.assertEqual(GraphSet.spill_threshold(), 0)
+        self.assertRaises(ValueError, GraphSet.spill_threshold, -1)
+
+    def test_frontier_order(self):
+        universe = grid(5)
+        shuffled = [universe[i * 7 % len(universe)]
+                    for i in range(len(universe))]
+
+        GraphSet.set_universe(shuffled, traversal='as-is')
+        self.assertTrue(GraphSet.max_frontier_size() > 6)
+
+        GraphSet.set_universe(shuffled, traversal='frontier')
+        self.assertTrue(GraphSet.max_frontier_size() <= 6)
+        self.assertEqual(set(GraphSet.universe()), set(shuffled))
+        self.assertEqual(len(GraphSet.paths(1, 25)), 8512)
+
+        GraphSet.set_universe(shuffled, traversal='frontier', source=13)
+        self.assertTrue(13 in GraphSet.universe()[0])
+        self.assertEqual(len(GraphSet.paths(1, 25)), 8512)
+
+        self.assertRaises(KeyError, GraphSet.set_universe, shuffled,
+                          'frontier', 26)
+
     def test_comparison(self):
         gs = GraphSet([g12])
         self.assertEqual(gs, GraphSet([g12]))
@@ -344,6 +541,13 @@ class TestGraphSet(unittest.TestCase):
         self.assertEqual(gs.graph_size(3), GraphSet([g123, g134]))
         self.assertTrue(isinstance(gs.len(3), GraphSet))
         self.assertEqual(gs.len(3), GraphSet([g123, g134]))
+        self.assertEqual(gs.graph_size_histogram(), [1, 2, 2, 2, 1])
+        self.assertEqual(GraphSet().graph_size_histogram(), [])
+
+        self.assertTrue(isinstance(gs.weight_range(0.35, 0.6), GraphSet))
+        self.assertEqual(gs.weight_range(0.35, 0.6), GraphSet([g134, g4]))
+        w = {e1: 3, e2: -2, e3: -2, e4: 4}
+        self.assertEqual(gs.weight_range(0, 3, w), GraphSet([g0, g1, g12, g1234]))
 
         gs = GraphSet([g12, g123, g234])
         self.assertTrue(isinstance(gs.minimal(), GraphSet))
@@ -540,6 +744,24 @@ class TestGraphSet(unittest.TestCase):
         self.assertTrue(isinstance(gs, GraphSet))
         self.assertEqual(gs, GraphSet([g0, g1, g12]))
 
+    def test_lazy(self):
+        u = GraphSet([g0, g1, g12, g123, g1234, g134, g14, g4])
+        v = GraphSet([g12, g14, g23, g34])
+        w = GraphSet([g0, g1, g12, g23, g4])
+
+        gs = ((u.lazy() & v) - w).evaluate()
+        self.assertTrue(isinstance(gs, GraphSet))
+        self.assertEqual(gs, (u & v) - w)
+
+        e = (u.lazy() | v) & w
+        self.assertEqual(e.evaluate(), (u | v) & w)
+        self.assertEqual(len(e), 5)
+        self.assertTrue(g12 in e)
+        self.assertEqual(e.graph_size(1), GraphSet([g1, g4]))
+
+        e = (v.lazy() - u) ^ ~w
+        self.assertEqual(e.evaluate(), (v - u) ^ ~w)
+
     def capacity(self):
         gs = GraphSet()
         self.assertFalse(gs)
@@ -621,6 +843,9 @@ class TestGraphSet(unittest.TestCase):
         self.assertTrue(e4 not in gs1)
         self.assertTrue(1 in gs1)
         self.assertTrue(4 not in gs1)
+        self.assertEqual(gs1.contains([g12, g2, g1, g0]),
+                         [True, False, True, False])
+        self.assertRaises(TypeError, gs1.contains, [e1])
 
     def test_modifiers(self):
         v = [g0, g12, g13]
@@ -730,6 +955,15 @@ class TestGraphSet(unittest.TestCase):
         gs = GraphSet.load(f)
         self.assertEqual(gs, GraphSet(v))
 
+        st = gs.dumps(binary=True)
+        gs = GraphSet.loads(st)
+        self.assertEqual(gs, GraphSet(v))
+
+        gs = pickle.loads(pickle.dumps(gs, pickle.HIGHEST_PROTOCOL))
+        self.assertTrue(isinstance(gs, GraphSet))
+        self.assertEqual(gs, GraphSet(v))
+        self.assertEqual(len(gs.paths(1, 2)), 1)
+
     def test_networkx(self):
         try:
             import networkx as nx
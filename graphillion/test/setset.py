@@ -18,6 +18,7 @@
 # WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 from graphillion import setset
+import pickle
 import tempfile
 import unittest
 
@@ -153,6 +154,14 @@ class TestSetset(unittest.TestCase):
         self.assertEqual(ss.set_size(3), setset([s123, s134]))
         self.assertTrue(isinstance(ss.len(3), setset))
         self.assertEqual(ss.len(3), setset([s123, s134]))
+        self.assertEqual(ss.size_histogram(), [1, 2, 2, 2, 1])
+
+        w = {'1': 3, '2': -2, '3': -2, '4': 4}
+        self.assertTrue(isinstance(ss.weight_range(0, 3, w), setset))
+        self.assertEqual(ss.weight_range(0, 3, w), setset([s0, s1, s12, s1234]))
+        self.assertEqual(ss.weight_range(4, 4, w), setset([s4]))
+        self.assertEqual(ss.weight_range(2, 3), setset([s12, s123, s134, s14]))
+        self.assertRaises(TypeError, ss.weight_range, 0, 3, {'1': 'x'})
 
         ss = setset([s12, s123, s234])
         self.assertTrue(isinstance(ss.minimal(), setset))
@@ -280,6 +289,13 @@ class TestSetset(unittest.TestCase):
         self.assertTrue(isinstance(ss, setset))
         self.assertEqual(ss, setset([s0, s1, s12, s14, s2, s23, s3, s34, s4]))
 
+        ss = setset(u).join(setset(v), num_threads=4, cutoff=2)
+        self.assertTrue(isinstance(ss, setset))
+        self.assertEqual(ss, setset(u).join(setset(v)))
+        ss = setset(u).meet(setset(v), 4)
+        self.assertTrue(isinstance(ss, setset))
+        self.assertEqual(ss, setset(u).meet(setset(v)))
+
         v = [s12, s14, s23, s34]
         ss = setset(u).subsets(setset(v))
         self.assertTrue(isinstance(ss, setset))
@@ -315,6 +331,50 @@ class TestSetset(unittest.TestCase):
         ss.clear()
         self.assertRaises(KeyError, ss.choice)
 
+    def test_lazy(self):
+        u = setset([s0, s1, s12, s123, s1234, s134, s14, s4])
+        v = setset([s12, s14, s23, s34])
+        w = setset([s0, s1, s12, s23, s4])
+
+        e = (u.lazy() & v) - w
+        self.assertEqual(e._op, '-')
+        self.assertEqual(e.evaluate(), (u & v) - w)
+        self.assertTrue(isinstance(e.evaluate(), setset))
+        self.assertEqual(len(e), 1)
+        self.assertTrue(s14 in e)
+        self.assertEqual(list(e), [s14])
+
+        e = (u.lazy() | v) & w
+        self.assertEqual(e.evaluate(), (u | v) & w)
+        e = w.lazy() & (u.lazy() | v)
+        self.assertEqual(e.evaluate(), w & (u | v))
+
+        # shared subexpressions are evaluated once and not fused
+        x = u.lazy() & v
+        e = (x - w) | (x ^ w)
+        self.assertEqual(e.evaluate(), ((u & v) - w) | ((u & v) ^ w))
+        self.assertEqual(len(e.evaluate()), len(e))
+
+        e = ~(u.lazy() - v) ^ w
+        self.assertEqual(e.evaluate(), ~(u - v) ^ w)
+        self.assertEqual(e.len(), len(~(u - v) ^ w))
+
+        # simplification
+        e = u.lazy() | u
+        self.assertEqual(e._op, 'leaf')
+        self.assertEqual(e.evaluate(), u)
+        e = (u.lazy() & v) - (v.lazy() & u)
+        self.assertEqual(e._op, 'leaf')
+        self.assertFalse(e)
+        e = ~~(u.lazy() ^ v)
+        self.assertEqual(e._op, '^')
+        self.assertEqual(e.evaluate(), u ^ v)
+        e = (u.lazy() & setset()) | v
+        self.assertEqual(e._op, 'leaf')
+        self.assertEqual(e.evaluate(), v)
+
+        self.assertRaises(TypeError, lambda: u.lazy() | [s1])
+
     def capacity(self):
         ss = setset()
         self.assertFalse(ss)
@@ -390,6 +450,9 @@ class TestSetset(unittest.TestCase):
         ss1 = setset([s0, s12, s13])
         self.assertTrue(s12 in ss1)
         self.assertTrue(s1 not in ss1)
+        self.assertEqual(ss1.contains([s13, s1, s0, s123, s12]),
+                         [True, False, True, False, True])
+        self.assertEqual(ss1.contains([]), [])
 
     def test_modifiers(self):
         v = [s0, s12, s13]
@@ -494,6 +557,49 @@ class TestSetset(unittest.TestCase):
         ss = setset.load(f)
         self.assertEqual(ss, setset(v))
 
+        st = ss.dumps(binary=True)
+        self.assertEqual(st[:4], '\x89ZDD')
+        self.assertTrue(len(st) < len(ss.dumps()))
+        self.assertEqual(setset.loads(st), setset(v))
+        self.assertEqual(setset.loads(setset().dumps(True)), setset())
+        st = st[:8] + chr(ord(st[8]) ^ 1) + st[9:]
+        self.assertRaises(ValueError, setset.loads, st)
+
+        f = tempfile.TemporaryFile('w+')
+        ss.dump(f)
+        f.seek(0)
+        self.assertEqual(f.read(), ss.dumps())
+        f = tempfile.TemporaryFile('w+b')
+        ss.dump(f)
+        f.seek(0)
+        self.assertEqual(f.read(), ss.dumps(binary=True))
+        f = tempfile.TemporaryFile('w+b')
+        ss.dump(f, binary=False)
+        ss.dump(f, binary=True)
+        f.seek(0)
+        self.assertEqual(setset.load(f), setset(v))
+        self.assertEqual(setset.load(f), setset(v))
+
+        for protocol in range(pickle.HIGHEST_PROTOCOL + 1):
+            st = pickle.dumps(ss, protocol)
+            self.assertEqual(pickle.loads(st), setset(v))
+            self.assertTrue(isinstance(pickle.loads(st), setset))
+        self.assertEqual(pickle.loads(pickle.dumps(setset())), setset())
+        st = pickle.dumps(ss)
+        setset.set_universe(['1', '2', '3', '5'])
+        self.assertRaises(ValueError, pickle.loads, st)
+        setset.set_universe(['1', '2', '3', '4'])
+
+        f = tempfile.TemporaryFile()
+        self.assertEqual(ss.write_sets(f), 8)
+        f.seek(0)
+        self.assertEqual(len(f.read()), 4 * (8 + 16))
+        f = tempfile.TemporaryFile()
+        self.assertEqual(ss.write_sets(f, 6), 2)
+        self.assertEqual(ss.write_sets(f, 2, 3), 3)
+        self.assertEqual(ss.write_sets(f, 8), 0)
+        self.assertRaises(ValueError, ss.write_sets, f, -1)
+
     def test_large(self):
         n = 1000
         setset.set_universe(xrange(n))
@@ -506,6 +612,21 @@ class TestSetset(unittest.TestCase):
             if i > 100: break
             i += 1
 
+        # more levels than the kernel's recursion limit
+        n = 9000
+        setset.set_universe(xrange(n))
+        ss = setset([set([1]), set([1, 2])])
+        self.assertEqual(~ss | ss, setset({}))
+        self.assertFalse(~ss & ss)
+        ss.flip()
+        self.assertEqual(ss.len(), 2)
+        self.assertEqual(sorted(len(s) for s in ss), [n - 2, n - 1])
+
+        ss = setset([set([1, n - 1])])
+        self.assertEqual(ss.hitting(),
+                         setset({'include': [1]}) |
+                         setset({'include': [n - 1], 'exclude': [1]}))
+
          # it takes more than 10 sec.
 #        self.assertRaises(RuntimeError, setset.set_universe, xrange(65536))
 
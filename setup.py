@@ -6,6 +6,7 @@ sys.path.insert(0, 'graphillion')
 import release
 
 sources_list = [os.path.join('src', 'pygraphillion.cc'),
+                os.path.join('src', 'graphillion', 'frozen_setset.cc'),
                 os.path.join('src', 'graphillion', 'graphset.cc'),
                 os.path.join('src', 'graphillion', 'setset.cc'),
                 os.path.join('src', 'graphillion', 'util.cc'),
@@ -22,6 +23,14 @@ else:
     libraries_list = []
     extra_link_args_list=[]
 
+# OpenMP is used to construct GraphSets in parallel; set GRAPHILLION_OPENMP=0
+# to build without it.
+extra_compile_args_list = []
+if sys.platform.startswith('linux') and \
+        os.environ.get('GRAPHILLION_OPENMP', '1') != '0':
+    extra_compile_args_list.append('-fopenmp')
+    extra_link_args_list.append('-fopenmp')
+
 setup(name='Graphillion',
       version=release.version,
       description='Fast, lightweight library for a huge number of graphs',
@@ -61,6 +70,7 @@ trillions of graphs can be processed on a single computer.
                   include_dirs=['src'],
                   libraries=libraries_list,
                   define_macros=[('B_64', None)],
+                  extra_compile_args=extra_compile_args_list,
                   extra_link_args=extra_link_args_list,
                   ),
         ],
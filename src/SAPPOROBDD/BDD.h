@@ -147,6 +147,7 @@ inline int BDD_NewVar(void)
 
 inline int BDD_LevOfVar(int v) { return bddlevofvar(v); }
 inline int BDD_VarOfLev(int lev) { return bddvaroflev(lev); }
+inline int BDD_Reserve(int v, bddword n) { return bddreserve(v, n); }
 
 inline BDD BDD_ID(bddword bdd)
   { BDD h; h._bdd = bdd; return h; }
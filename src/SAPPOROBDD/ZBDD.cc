@@ -44,6 +44,11 @@ static const char BC_ZBDD_ALWAYS = 26;
 static const char BC_ZBDD_SYMSET = 27;
 static const char BC_ZBDD_COIMPSET = 28;
 static const char BC_ZBDD_MEET = 29;
+static const char BC_ZBDD_COMPL = 30;
+static const char BC_ZBDD_CHGALL = 31;
+static const char BC_ZBDD_HITTING = 32;
+static const char BC_ZBDD_SLICE = 33;
+static const char BC_ZBDD_SYMDIFF = 34;
 
 static const char BC_ZBDD_ZSkip = 65;
 static const char BC_ZBDD_INTERSEC = 66;
@@ -162,6 +167,25 @@ ZBDD ZBDD::PermitSym(int n) const
   ZBDD_CACHE_ENT_RETURN(BC_ZBDD_PERMITSYM, fx, n, h);
 }
 
+ZBDD ZBDD::Slice(int n) const
+{
+  if(*this == -1) return -1;
+  if(*this == 0 || n < 0) return 0;
+  if(*this == 1) return (n == 0)? 1: 0;
+  if(n == 0) return *this & 1;
+
+  int top = Top();
+
+  bddword fx = GetID();
+  ZBDD_CACHE_CHK_RETURN(BC_ZBDD_SLICE, fx, n);
+
+  ZBDD f1 = OnSet0(top);
+  ZBDD f0 = OffSet(top);
+  ZBDD h = ZBDD_Node(top, f0.Slice(n), f1.Slice(n - 1));
+
+  ZBDD_CACHE_ENT_RETURN(BC_ZBDD_SLICE, fx, n, h);
+}
+
 ZBDD ZBDD::Always() const
 {
   if(*this == -1) return -1;
@@ -180,6 +204,135 @@ ZBDD ZBDD::Always() const
   ZBDD_CACHE_ENT_RETURN(BC_ZBDD_ALWAYS, fx, 0, h);
 }
 
+// Complement of f within the power set of the variables at levels
+// (lev, t].  The level pair is packed into the cache key.  The levels
+// above the top of f are built in a loop, so the recursion depth follows
+// the nodes of f rather than the number of levels.
+static ZBDD ZBDD_Compl(const ZBDD& f, int t, int lev)
+{
+  if(f == -1) return -1;
+  if(t <= lev) return ZBDD(1) - f;
+
+  bddword fx = f.GetID();
+  bddword gx = ((bddword)t << B_VAR_WIDTH) | lev;
+  ZBDD_CACHE_CHK_RETURN(BC_ZBDD_COMPL, fx, gx);
+
+  int c = BDD_LevOfVar(f.Top());
+  if(c > t) BDDerr("ZBDD::Complement(): invalid level.", t);
+  ZBDD h;
+  if(c == t)
+  {
+    int v = f.Top();
+    h = ZBDD_Node(v, ZBDD_Compl(f.OffSet(v), t - 1, lev),
+                     ZBDD_Compl(f.OnSet0(v), t - 1, lev));
+  }
+  else
+  {
+    if(c < lev) c = lev;
+    h = ZBDD_Compl(f, c, lev);
+    ZBDD p = ZBDD_Compl(0, c, lev);
+    for(int l = c + 1; l <= t; l++)
+    {
+      int v = BDD_VarOfLev(l);
+      h = ZBDD_Node(v, h, p);
+      p = ZBDD_Node(v, p, p);
+    }
+  }
+
+  ZBDD_CACHE_ENT_RETURN(BC_ZBDD_COMPL, fx, gx, h);
+}
+
+// Changes every variable at levels (lev, t] in each set of f.
+static ZBDD ZBDD_ChgAll(const ZBDD& f, int t, int lev)
+{
+  if(f == -1) return -1;
+  if(f == 0) return 0;
+  if(t <= lev) return f;
+
+  bddword fx = f.GetID();
+  bddword gx = ((bddword)t << B_VAR_WIDTH) | lev;
+  ZBDD_CACHE_CHK_RETURN(BC_ZBDD_CHGALL, fx, gx);
+
+  int c = BDD_LevOfVar(f.Top());
+  if(c > t) BDDerr("ZBDD::ChangeAll(): invalid level.", t);
+  ZBDD h;
+  if(c == t)
+  {
+    int v = f.Top();
+    h = ZBDD_Node(v, ZBDD_ChgAll(f.OnSet0(v), t - 1, lev),
+                     ZBDD_ChgAll(f.OffSet(v), t - 1, lev));
+  }
+  else
+  {
+    if(c < lev) c = lev;
+    h = ZBDD_ChgAll(f, c, lev);
+    for(int l = c + 1; l <= t; l++) h = ZBDD_Node(BDD_VarOfLev(l), 0, h);
+  }
+
+  ZBDD_CACHE_ENT_RETURN(BC_ZBDD_CHGALL, fx, gx, h);
+}
+
+// Sets of the variables at levels (lev, t] that intersect every set in f.
+// A variable skipped by f is free, so it gets a node with equal children.
+// The 0-edge of a real node is taken as Hitting(f0 + f1) rather than
+// Hitting(f0) & Hitting(f1), since intersecting two runs of free nodes
+// would recurse once per level.
+static ZBDD ZBDD_Hitting(const ZBDD& f, int t, int lev)
+{
+  if(f == -1) return -1;
+  if(f == 0) return ZBDD_Compl(0, t, lev);
+  if(f == 1 || t <= lev) return 0;
+
+  bddword fx = f.GetID();
+  bddword gx = ((bddword)t << B_VAR_WIDTH) | lev;
+  ZBDD_CACHE_CHK_RETURN(BC_ZBDD_HITTING, fx, gx);
+
+  int c = BDD_LevOfVar(f.Top());
+  if(c > t) BDDerr("ZBDD::Hitting(): invalid level.", t);
+  ZBDD h;
+  if(c == t)
+  {
+    int v = f.Top();
+    ZBDD f0 = f.OffSet(v);
+    ZBDD f1 = f.OnSet0(v);
+    h = ZBDD_Node(v, ZBDD_Hitting(f0 + f1, t - 1, lev),
+                     ZBDD_Hitting(f0, t - 1, lev));
+  }
+  else
+  {
+    if(c < lev) c = lev;
+    h = ZBDD_Hitting(f, c, lev);
+    for(int l = c + 1; l <= t; l++)
+    {
+      int v = BDD_VarOfLev(l);
+      h = ZBDD_Node(v, h, h);
+    }
+  }
+
+  ZBDD_CACHE_ENT_RETURN(BC_ZBDD_HITTING, fx, gx, h);
+}
+
+ZBDD ZBDD::Complement(int lev) const
+{
+  if(lev < 0 || lev > BDD_TopLev())
+    BDDerr("ZBDD::Complement(): invalid level.", lev);
+  return ZBDD_Compl(*this, BDD_TopLev(), lev);
+}
+
+ZBDD ZBDD::ChangeAll(int lev) const
+{
+  if(lev < 0 || lev > BDD_TopLev())
+    BDDerr("ZBDD::ChangeAll(): invalid level.", lev);
+  return ZBDD_ChgAll(*this, BDD_TopLev(), lev);
+}
+
+ZBDD ZBDD::Hitting(int lev) const
+{
+  if(lev < 0 || lev > BDD_TopLev())
+    BDDerr("ZBDD::Hitting(): invalid level.", lev);
+  return ZBDD_Hitting(*this, BDD_TopLev(), lev);
+}
+
 int ZBDD::SymChk(int v1, int v2) const
 {
   if(*this == -1) return -1;
@@ -555,6 +708,33 @@ ZBDD ZBDD_Meet(const ZBDD& fc, const ZBDD& gc)
   ZBDD_CACHE_ENT_RETURN(BC_ZBDD_MEET, fx, gx, h);
 }
 
+ZBDD ZBDD_SymDiff(const ZBDD& fc, const ZBDD& gc)
+{
+  if(fc == -1) return -1;
+  if(gc == -1) return -1;
+  if(fc == 0) return gc;
+  if(gc == 0) return fc;
+  if(fc == gc) return 0;
+
+  ZBDD f = fc; ZBDD g = gc;
+  bddword fx = f.GetID();
+  bddword gx = g.GetID();
+  if(fx < gx)
+  {
+    f = gc; g = fc;
+    fx = f.GetID(); gx = g.GetID();
+  }
+
+  ZBDD_CACHE_CHK_RETURN(BC_ZBDD_SYMDIFF, fx, gx);
+
+  int top = f.Top();
+  if(BDD_LevOfVar(top) < BDD_LevOfVar(g.Top())) top = g.Top();
+  ZBDD h = ZBDD_Node(top, ZBDD_SymDiff(f.OffSet(top), g.OffSet(top)),
+                          ZBDD_SymDiff(f.OnSet0(top), g.OnSet0(top)));
+
+  ZBDD_CACHE_ENT_RETURN(BC_ZBDD_SYMDIFF, fx, gx, h);
+}
+
 ZBDD ZBDD_Random(int lev, int density)
 {
   if(lev < 0) BDDerr("ZBDD_Random(): lev < 0.", lev);
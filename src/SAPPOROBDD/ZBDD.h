@@ -106,9 +106,13 @@ public:
   ZBDD Restrict(const ZBDD&) const;
   ZBDD Permit(const ZBDD&) const;
   ZBDD PermitSym(int) const;
+  ZBDD Slice(int) const;
   ZBDD Support(void) const
     { ZBDD h; h._zbdd = bddsupport(_zbdd); return h; }
   ZBDD Always(void) const;
+  ZBDD Complement(int lev = 0) const;
+  ZBDD ChangeAll(int lev = 0) const;
+  ZBDD Hitting(int lev = 0) const;
 
   int SymChk(int, int) const;
   ZBDD SymGrp(void) const;
@@ -135,6 +139,7 @@ public:
 extern ZBDD operator*(const ZBDD&, const ZBDD&);
 extern ZBDD operator/(const ZBDD&, const ZBDD&);
 extern ZBDD ZBDD_Meet(const ZBDD&, const ZBDD&);
+extern ZBDD ZBDD_SymDiff(const ZBDD&, const ZBDD&);
 extern ZBDD ZBDD_Random(int, int density = 50);
 extern ZBDD ZBDD_Import(FILE *strm = stdin);
 
@@ -157,6 +162,9 @@ inline ZBDD operator+(const ZBDD& f, const ZBDD& g)
 inline ZBDD operator-(const ZBDD& f, const ZBDD& g)
   { return ZBDD_ID(bddsubtract(f.GetID(), g.GetID())); }
 
+inline ZBDD ZBDD_Node(int v, const ZBDD& f0, const ZBDD& f1)
+  { return ZBDD_ID(bddmakenodez(v, f0.GetID(), f1.GetID())); }
+
 inline ZBDD operator%(const ZBDD& f, const ZBDD& p)
   { return f - (f/p) * p; }
 
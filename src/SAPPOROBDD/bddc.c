@@ -236,6 +236,7 @@ static int  rfc_inc_ovf B_ARG((struct B_NodeTable *np));
 static int  rfc_dec_ovf B_ARG((struct B_NodeTable *np));
 static void var_enlarge B_ARG((void));
 static int  node_enlarge B_ARG((void));
+static int  hash_init B_ARG((bddvar v));
 static int  hash_enlarge B_ARG((bddvar v));
 static bddp getnode B_ARG((bddvar v, bddp f0, bddp f1));
 static bddp getbddp B_ARG((bddvar v, bddp f0, bddp f1));
@@ -1144,6 +1145,67 @@ bddvar 	v;
   return apply(f, (bddp)v, BC_CHANGE, 0);
 }
 
+bddp    bddmakenodez(v, f0, f1)
+bddvar  v;
+bddp    f0, f1;
+/* Returns bddnull if not enough memory */
+{
+  struct B_NodeTable *fp;
+  bddp h;
+
+  /* Check operands */
+  if(v > VarUsed || v == 0) err("bddmakenodez: Invalid VarID", v);
+  if(f0 == bddnull) return bddnull;
+  if(f1 == bddnull) return bddnull;
+  if(!B_CST(f0))
+  {
+    fp = B_NP(f0);
+    if(fp>=Node+NodeSpc || !fp->varrfc)
+      err("bddmakenodez: Invalid bddp", f0);
+    if(!B_Z_NP(fp)) err("bddmakenodez: applying non-ZBDD node", f0);
+    if(Var[B_VAR_NP(fp)].lev >= Var[v].lev)
+      err("bddmakenodez: Invalid level order", f0);
+  }
+  if(!B_CST(f1))
+  {
+    fp = B_NP(f1);
+    if(fp>=Node+NodeSpc || !fp->varrfc)
+      err("bddmakenodez: Invalid bddp", f1);
+    if(!B_Z_NP(fp)) err("bddmakenodez: applying non-ZBDD node", f1);
+    if(Var[B_VAR_NP(fp)].lev >= Var[v].lev)
+      err("bddmakenodez: Invalid level order", f1);
+  }
+
+  bddcopy(f0);
+  bddcopy(f1);
+  h = getzbddp(v, f0, f1);
+  if(h == bddnull) { bddfree(f0); bddfree(f1); } /* Overflow */
+  return h;
+}
+
+int     bddreserve(v, n)
+bddvar  v;
+bddp    n;
+/* Returns 1 if not enough memory */
+{
+  struct B_VarTable *varp;
+
+  /* Check operands */
+  if(v > VarUsed || v == 0) err("bddreserve: Invalid VarID", v);
+
+  /* Hash-table of the variable */
+  varp = &Var[v];
+  if(varp->hashSpc == 0 && hash_init(v)) return 1;
+  while(varp->hashUsed + n >= varp->hashSpc &&
+        varp->hashSpc != B_NODE_MAX + 1U)
+    if(hash_enlarge(v)) return 1;
+
+  /* Node-table; GC will make room beyond its limit */
+  while(NodeUsed + n >= NodeSpc - 1U && NodeSpc != NodeLimit)
+    if(node_enlarge()) return 1;
+  return 0;
+}
+
 bddp bddintersec(f, g)
 bddp f, g;
 /* Returns bddnull if not enough memory */
@@ -1419,6 +1481,37 @@ static int node_enlarge()
   return 0;
 }
 
+static int hash_init(v)
+bddvar v;
+/* Returns 1 if not enough memory */
+{
+  struct B_VarTable *varp;
+  bddp ix;
+  bddp_32 *p_32;
+#ifdef B_64
+  bddp_h8 *p_h8;
+#endif
+
+  varp = &Var[v];
+  varp->hash_32 = B_MALLOC(bddp_32, B_HASH_SPC0);
+  if(!varp->hash_32) return 1;
+#ifdef B_64
+  varp->hash_h8 = B_MALLOC(bddp_h8, B_HASH_SPC0);
+  if(!varp->hash_h8)
+  {
+    free(varp->hash_32);
+    return 1;
+  }
+#endif
+  for(ix=0; ix<B_HASH_SPC0; ix++)
+  {
+    B_SET_NXP(p, varp->hash, ix);
+    B_SET_BDDP(*p, bddnull);
+  }
+  varp->hashSpc = B_HASH_SPC0;
+  return 0;
+}
+
 static int hash_enlarge(v)
 bddvar v;
 /* Returns 1 if not enough memory */
@@ -1515,7 +1608,7 @@ bddp    f0, f1;
   /* After checking elimination rule & negative edge rule */
   struct B_NodeTable *np, *fp;
   struct B_VarTable *varp;
-  bddp ix, nx, key;
+  bddp nx, key;
   bddp_32 *p_32;
 #ifdef B_64
   bddp_h8 *p_h8;
@@ -1525,22 +1618,7 @@ bddp    f0, f1;
   if(varp->hashSpc == 0)
   /* Create hash-table */
   {
-    varp->hash_32 = B_MALLOC(bddp_32, B_HASH_SPC0);
-    if(!varp->hash_32) return bddnull;
-#ifdef B_64
-    varp->hash_h8 = B_MALLOC(bddp_h8, B_HASH_SPC0);
-    if(!varp->hash_h8)
-    {
-      free(varp->hash_32);
-      return bddnull;
-    }
-#endif
-    for(ix=0; ix<B_HASH_SPC0; ix++)
-    {
-      B_SET_NXP(p, varp->hash, ix);
-      B_SET_BDDP(*p, bddnull);
-    }
-    varp->hashSpc = B_HASH_SPC0;
+    if(hash_init(v)) return bddnull;
     key = B_HASHKEY(f0, f1, varp->hashSpc);
   }
   else
@@ -139,6 +139,8 @@ extern bddp   bddoffset B_ARG((bddp f, bddvar v));
 extern bddp   bddonset B_ARG((bddp f, bddvar v));
 extern bddp   bddonset0 B_ARG((bddp f, bddvar v));
 extern bddp   bddchange B_ARG((bddp f, bddvar v));
+extern bddp   bddmakenodez B_ARG((bddvar v, bddp f0, bddp f1));
+extern int    bddreserve B_ARG((bddvar v, bddp n));
 extern bddp   bddintersec B_ARG((bddp f, bddp g));
 extern bddp   bddunion B_ARG((bddp f, bddp g));
 extern bddp   bddsubtract B_ARG((bddp f, bddp g));
@@ -0,0 +1,94 @@
+/*********************************************************************
+Copyright 2013  JST ERATO Minato project and other contributors
+http://www-erato.ist.hokudai.ac.jp/?language=en
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**********************************************************************/
+
+// Times setset::hitting() on a few families.  Not run by ctest; build the
+// bench_hitting target and run it by hand.
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+#include <set>
+#include <vector>
+
+#include "graphillion/setset.h"
+
+namespace graphillion {
+
+using namespace std;
+
+void bench(const char* name, int n, const vector<set<int> >& v) {
+  setset::num_elems(n);
+  setset ss(v);
+  clock_t start = clock();
+  setset h = ss.hitting();
+  double sec = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+  printf("%-20s %6d elems  %8.3fs\n", name, n, sec);
+}
+
+vector<set<int> > path(int n) {
+  vector<set<int> > v;
+  for (int i = 1; i < n; ++i) {
+    set<int> s;
+    s.insert(i);
+    s.insert(i + 1);
+    v.push_back(s);
+  }
+  return v;
+}
+
+vector<set<int> > ends(int n) {
+  set<int> s;
+  s.insert(1);
+  s.insert(n);
+  return vector<set<int> >(1, s);
+}
+
+vector<set<int> > random_sets(int n, int k, int m) {
+  vector<set<int> > v;
+  srand(1);
+  for (int i = 0; i < m; ++i) {
+    set<int> s;
+    while (static_cast<int>(s.size()) < k)
+      s.insert(rand() % n + 1);
+    v.push_back(s);
+  }
+  return v;
+}
+
+}  // namespace graphillion
+
+int main() {
+  using namespace graphillion;
+  bench("path {i,i+1}", 1000, path(1000));
+  bench("path {i,i+1}", 4000, path(4000));
+  bench("{1,n}", 9000, ends(9000));
+  bench("{1,n}", 10000, ends(10000));
+  bench("8 random 3-sets", 4000, random_sets(4000, 3, 8));
+  bench("8 random 3-sets", 10000, random_sets(10000, 3, 8));
+  bench("16 random 3-sets", 100, random_sets(100, 3, 16));
+  bench("12 random 4-sets", 500, random_sets(500, 4, 12));
+  bench("20 random 3-sets", 200, random_sets(200, 3, 20));
+  return 0;
+}
@@ -0,0 +1,140 @@
+/*********************************************************************
+Copyright 2013  JST ERATO Minato project and other contributors
+http://www-erato.ist.hokudai.ac.jp/?language=en
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**********************************************************************/
+
+#include "graphillion/frozen_setset.h"
+
+#include <limits>
+#include <map>
+
+#include "graphillion/setset.h"
+#include "graphillion/zdd.h"
+
+namespace graphillion {
+
+using std::map;
+using std::numeric_limits;
+using std::set;
+using std::string;
+using std::vector;
+
+frozen_setset::frozen_setset()
+    : nodes_(2), counts_(2), root_(0), num_elems_(0), size_("0") {
+  for (uint32_t i = 0; i < 2; ++i) {
+    this->nodes_[i].elem = numeric_limits<elem_t>::max();
+    this->nodes_[i].lo = this->nodes_[i].hi = i;
+    this->counts_[i] = i;
+  }
+}
+
+frozen_setset::frozen_setset(const setset& ss) {
+  *this = frozen_setset();
+  this->num_elems_ = graphillion::num_elems();
+  this->size_ = ss.size();
+  zdd_t f = ss.zdd_;
+  if (f == bot() || f == top()) {
+    this->root_ = f == top() ? 1 : 0;
+    return;
+  }
+  vector<vector<zdd_t> > stacks(this->num_elems_ + 1);
+  set<word_t> visited;
+  sort_zdd(f, &stacks, &visited);
+  assert(visited.size() < numeric_limits<uint32_t>::max() - 2);
+  this->nodes_.reserve(visited.size() + 2);
+  this->counts_.reserve(visited.size() + 2);
+  map<word_t, uint32_t> index;
+  index[id(bot())] = 0;
+  index[id(top())] = 1;
+  for (elem_t v = this->num_elems_; v > 0; --v) {
+    for (vector<zdd_t>::const_iterator i = stacks[v].begin();
+         i != stacks[v].end(); ++i) {
+      node n;
+      n.elem = v;
+      n.lo = index[id(lo(*i))];
+      n.hi = index[id(hi(*i))];
+      index[id(*i)] = this->nodes_.size();
+      this->nodes_.push_back(n);
+      this->counts_.push_back(this->counts_[n.lo] + this->counts_[n.hi]);
+    }
+  }
+  this->root_ = index[id(f)];
+}
+
+bool frozen_setset::contains(const set<elem_t>& s) const {
+  uint32_t i = this->root_;
+  set<elem_t>::const_iterator e = s.begin();
+  while (i > 1) {
+    const node& n = this->nodes_[i];
+    if (e != s.end() && *e < n.elem) return false;
+    if (e != s.end() && *e == n.elem) {
+      i = n.hi;
+      ++e;
+    } else {
+      i = n.lo;
+    }
+  }
+  return i == 1 && e == s.end();
+}
+
+set<elem_t> frozen_setset::best_set(const vector<double>& weights) const {
+  assert(!this->empty());
+  assert(weights.size() == static_cast<size_t>(this->num_elems_ + 1));
+  vector<double> values(this->root_ + 1);
+  values[0] = -numeric_limits<double>::infinity();
+  values[1] = 0;
+  for (uint32_t i = 2; i <= this->root_; ++i) {
+    const node& n = this->nodes_[i];
+    double h = values[n.hi] + weights[n.elem];
+    values[i] = values[n.lo] < h ? h : values[n.lo];
+  }
+  set<elem_t> s;
+  uint32_t i = this->root_;
+  while (i > 1) {
+    const node& n = this->nodes_[i];
+    if (values[n.lo] < values[n.hi] + weights[n.elem]) {
+      s.insert(n.elem);
+      i = n.hi;
+    } else {
+      i = n.lo;
+    }
+  }
+  return s;
+}
+
+vector<double> frozen_setset::marginals() const {
+  vector<double> m(this->num_elems_ + 1, 0);
+  if (this->empty()) return m;
+  vector<double> paths(this->root_ + 1, 0);  // paths from the root
+  paths[this->root_] = 1;
+  for (uint32_t i = this->root_; i > 1; --i) {
+    const node& n = this->nodes_[i];
+    paths[n.lo] += paths[i];
+    paths[n.hi] += paths[i];
+    m[n.elem] += paths[i] * this->counts_[n.hi];
+  }
+  for (elem_t e = 1; e <= this->num_elems_; ++e)
+    m[e] /= this->counts_[this->root_];
+  return m;
+}
+
+}  // namespace graphillion
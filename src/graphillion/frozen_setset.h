@@ -0,0 +1,102 @@
+/*********************************************************************
+Copyright 2013  JST ERATO Minato project and other contributors
+http://www-erato.ist.hokudai.ac.jp/?language=en
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**********************************************************************/
+
+#ifndef GRAPHILLION_FROZEN_SETSET_H_
+#define GRAPHILLION_FROZEN_SETSET_H_
+
+#include <cassert>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "graphillion/type.h"
+
+namespace graphillion {
+
+class setset;
+
+// Immutable snapshot of a setset for query-only workloads.  Nodes are copied
+// into a flat array sorted by element from the bottom of the diagram, so
+// children always precede their parents and bottom-up computations are linear
+// scans.  Queries touch neither ZBDD handles nor the SAPPOROBDD manager, and
+// all const methods are safe to call concurrently.
+class frozen_setset {
+ public:
+  frozen_setset();
+  explicit frozen_setset(const setset& ss);
+
+  bool empty() const { return this->root_ == 0; }
+  std::string size() const { return this->size_; }
+  size_t num_nodes() const { return this->nodes_.size(); }
+  elem_t num_elems() const { return this->num_elems_; }
+
+  bool contains(const std::set<elem_t>& s) const;
+
+  // Draws a set uniformly; random() must return a number in [0, 1).  It may
+  // be a function or a generator object, so that each thread can draw with
+  // its own state.
+  template <typename RNG>
+  std::set<elem_t> random_set(RNG& random) const;
+
+  // Returns a set maximizing the sum of weights indexed by element.
+  std::set<elem_t> best_set(const std::vector<double>& weights) const;
+
+  // Returns the fraction of sets that contain each element, indexed by
+  // element.
+  std::vector<double> marginals() const;
+
+ private:
+  struct node {
+    elem_t elem;
+    uint32_t lo;
+    uint32_t hi;
+  };
+
+  std::vector<node> nodes_;     // 0 and 1 are the terminals
+  std::vector<double> counts_;  // number of sets in each node
+  uint32_t root_;
+  elem_t num_elems_;
+  std::string size_;
+};
+
+template <typename RNG>
+std::set<elem_t> frozen_setset::random_set(RNG& random) const {
+  assert(!this->empty());
+  std::set<elem_t> s;
+  uint32_t i = this->root_;
+  while (i > 1) {
+    const node& n = this->nodes_[i];
+    if (random() * this->counts_[i] < this->counts_[n.hi]) {
+      s.insert(n.elem);
+      i = n.hi;
+    } else {
+      i = n.lo;
+    }
+  }
+  return s;
+}
+
+}  // namespace graphillion
+
+#endif  // GRAPHILLION_FROZEN_SETSET_H_
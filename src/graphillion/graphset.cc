@@ -24,7 +24,15 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "graphillion/graphset.h"
 
+#include <stdint.h>
+
+#include <algorithm>
 #include <climits>
+#include <cmath>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include <set>
 #include <vector>
@@ -35,6 +43,8 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "subsetting/spec/DegreeConstraint.hpp"
 #include "subsetting/spec/FrontierBasedSearch.hpp"
 #include "subsetting/spec/LinearConstraints.hpp"
+#include "subsetting/spec/Lookahead.hpp"
+#include "subsetting/spec/PathSearch.hpp"
 #include "subsetting/spec/SapporoZdd.hpp"
 #include "subsetting/spec/SizeConstraint.hpp"
 #include "subsetting/util/Graph.hpp"
@@ -48,6 +58,161 @@ using std::pair;
 using std::set;
 using std::vector;
 
+namespace {
+
+bool compact_states = false;
+int lookahead_depth = 0;
+
+// Constraints composed into a single intersection spec, so that the search
+// space is swept and reduced only once.  They are nested in the order of
+// degree, size and linear constraints around the frontier-based search, so
+// that cheaper specs reject states earlier.
+struct Pipeline {
+  DegreeConstraint* dc;
+  SizeConstraint* sc;
+  LinearConstraints<double>* lc;
+  LinearConstraints<int64_t>* lci;  // constraints with decimal weights
+  ZddStructure* dd;
+  bool built;  // false if dd is to be constructed from scratch
+};
+
+// Leaves the result unreduced; it is reduced while converted to ZBDD.
+template<typename SPEC>
+void Build(DdSpec<SPEC>& spec, Pipeline* p) {
+  if (p->built) {
+    p->dd->subset(spec, false);
+  } else {
+    *p->dd = ZddStructure(spec, false);
+    p->built = true;
+  }
+}
+
+// Wraps the composite spec in lookahead, if enabled, so that dead states are
+// dropped before they widen the levels below.
+template<typename SPEC>
+void Apply(SPEC& spec, Pipeline* p) {
+  if (lookahead_depth > 0) {
+    ZddLookahead<SPEC> zl(spec, lookahead_depth);
+    Build(zl, p);
+  } else {
+    Build(spec, p);
+  }
+}
+
+template<typename SPEC>
+void FuseDegree(SPEC& spec, Pipeline* p) {
+  if (p->dc != NULL) {
+    ZddIntersection<DegreeConstraint,SPEC> zi(*p->dc, spec);
+    Apply(zi, p);
+  } else {
+    Apply(spec, p);
+  }
+}
+
+template<typename SPEC>
+void FuseSize(SPEC& spec, Pipeline* p) {
+  if (p->sc != NULL) {
+    ZddIntersection<SizeConstraint,SPEC> zi(*p->sc, spec);
+    FuseDegree(zi, p);
+  } else {
+    FuseDegree(spec, p);
+  }
+}
+
+template<typename SPEC>
+void FuseFixedPoint(SPEC& spec, Pipeline* p) {
+  if (p->lci != NULL) {
+    ZddIntersection<LinearConstraints<int64_t>,SPEC> zi(*p->lci, spec);
+    FuseSize(zi, p);
+  } else {
+    FuseSize(spec, p);
+  }
+}
+
+template<typename SPEC>
+void FuseLinear(SPEC& spec, Pipeline* p) {
+  if (p->lc != NULL) {
+    ZddIntersection<LinearConstraints<double>,SPEC> zi(*p->lc, spec);
+    FuseFixedPoint(zi, p);
+  } else {
+    FuseFixedPoint(spec, p);
+  }
+}
+
+// Returns true if `x` is exactly the double nearest to a multiple of
+// 1/`scale`; no tolerance is allowed, so 0.1 * 3 is not a decimal.
+bool IsDecimal(double x, int64_t scale) {
+  return std::floor(x * scale + 0.5) / scale == x;
+}
+
+// Returns the smallest power of ten, up to 10^6, at which all the weights
+// of `constraint` are decimals, or 0 if there is none.  Integer weights let
+// the constraint count in exact arithmetic and merge the states no later
+// edge can tell apart; sums of the scaled weights must stay exact in double.
+int64_t FixedPointScale(const linear_constraint_t& constraint) {
+  int64_t scale = 1;
+  for (int k = 0; k <= 6; ++k, scale *= 10) {
+    double total = 0;
+    bool integral = true;
+    for (vector<weighted_edge_t>::const_iterator j = constraint.first.begin();
+         integral && j != constraint.first.end(); ++j) {
+      integral = IsDecimal(j->second, scale);
+      total += std::fabs(j->second * scale);
+    }
+    if (integral) return total < 1e15 ? scale : 0;
+  }
+  return 0;
+}
+
+// Scales a bound to the integer one with the same solutions; infinite and
+// huge bounds are clamped just beyond any reachable sum.
+int64_t ScaleBound(double bound, int64_t scale, double limit, bool lower) {
+  double b = bound * scale;
+  if (IsDecimal(bound, scale)) b = std::floor(b + 0.5);
+  else b = lower ? std::ceil(b) : std::floor(b);
+  return static_cast<int64_t>(std::max(-limit, std::min(b, limit)));
+}
+
+// Searches s-t paths, or cycles if `s` and `t` are NULL, with a single
+// Simpath-style spec instead of degree constraints and components.
+zdd_t SearchPathsOrCycles(const vector<edge_t>& graph, const vertex_t* s,
+                          const vertex_t* t, bool is_hamilton,
+                          const zdd_t* search_space) {
+  assert(static_cast<size_t>(setset::num_elems()) == graph.size());
+  assert((s == NULL) == (t == NULL));
+
+  Graph g;
+  for (vector<edge_t>::const_iterator e = graph.begin(); e != graph.end(); ++e)
+    g.addEdge(e->first, e->second);
+  g.update();
+  assert(static_cast<size_t>(g.edgeSize()) == graph.size());
+
+  MessageHandler mh;
+  mh.begin("searching") << (s != NULL ? " paths" : " cycles");
+
+  ZddStructure dd;
+  Pipeline p = {NULL, NULL, NULL, NULL, &dd, false};
+  if (search_space != NULL) {
+    SapporoZdd f(*search_space, setset::max_elem() - setset::num_elems());
+    dd = ZddStructure(f);
+    p.built = true;
+  }
+
+  PathSearch ps(g, s != NULL ? g.getVertex(*s) : 0,
+                t != NULL ? g.getVertex(*t) : 0, is_hamilton, compact_states);
+  Apply(ps, &p);
+
+  MessageHandler mh2;
+  mh2.begin("conversion") << " to ZBDD";
+  zdd_t f = dd.reduceAndEvaluate(
+      ToZBDD(setset::max_elem() - setset::num_elems()));
+  mh2.end();
+  mh.end();
+  return f;
+}
+
+}  // namespace
+
 Range::Range(int max) : min_(0), max_(max - 1), step_(1) {
   assert(this->min_ <= this->max_);
 }
@@ -88,12 +253,15 @@ setset SearchGraphs(
   g.update();
   assert(static_cast<size_t>(g.edgeSize()) == graph.size());
 
+  MessageHandler mh;
+  mh.begin("searching") << " graphs";
+
   ZddStructure dd;
+  Pipeline p = {NULL, NULL, NULL, NULL, &dd, false};
   if (search_space != NULL) {
     SapporoZdd f(search_space->zdd_, setset::max_elem() - setset::num_elems());
     dd = ZddStructure(f);
-  } else {
-    dd = ZddStructure(g.edgeSize());
+    p.built = true;
   }
 
   if (vertex_groups != NULL) {
@@ -105,49 +273,148 @@ setset SearchGraphs(
     g.update();
   }
 
-  DegreeConstraint dc(g);
+  DegreeConstraint dc(g, NULL, compact_states);
   if (degree_constraints != NULL) {
     for (map<vertex_t, Range>::const_iterator i = degree_constraints->begin();
          i != degree_constraints->end(); ++i)
       dc.setConstraint(i->first, &i->second);
-    dd.subset(dc);
-  }
-
-  if (num_edges != NULL) {
-    SizeConstraint sc(g.edgeSize(), num_edges);
-    dd.subset(sc);
+    p.dc = &dc;
   }
 
-  FrontierBasedSearch fbs(g, num_comps, no_loop);
+  SizeConstraint sc(g.edgeSize(), num_edges);
+  if (num_edges != NULL)
+    p.sc = &sc;
 
+  LinearConstraints<double> lc(g.edgeSize());
+  LinearConstraints<int64_t> lci(g.edgeSize());
   if (linear_constraints != NULL) {
-    LinearConstraints<double> lc(g.edgeSize());
     for (vector<linear_constraint_t>::const_iterator
          i = linear_constraints->begin();
          i != linear_constraints->end(); ++i) {
+      int64_t scale = FixedPointScale(*i);
       map<int,double> expr;
       for (std::vector<weighted_edge_t>::const_iterator
            j = i->first.begin(); j != i->first.end(); ++j) {
         int level = g.edgeSize() - g.getEdge(j->first);
         expr[level] = j->second;
       }
-      lc.addConstraint(expr, i->second.first, i->second.second);
+      if (scale > 0) {
+        map<int,int64_t> iexpr;
+        double limit = 1;
+        for (map<int,double>::const_iterator j = expr.begin();
+             j != expr.end(); ++j) {
+          iexpr[j->first] = static_cast<int64_t>(
+              std::floor(j->second * scale + 0.5));
+          limit += std::fabs(static_cast<double>(iexpr[j->first]));
+        }
+        lci.addConstraint(iexpr,
+                          ScaleBound(i->second.first, scale, limit, true),
+                          ScaleBound(i->second.second, scale, limit, false));
+        p.lci = &lci;
+      } else {
+        lc.addConstraint(expr, i->second.first, i->second.second);
+        p.lc = &lc;
+      }
     }
-    lc.update();
-    ZddIntersection<LinearConstraints<double>,FrontierBasedSearch> zi(lc, fbs);
-
-    dd.subset(zi);
-  }
-  else {
-    dd.subset(fbs);
+    if (p.lci != NULL) lci.update();
+    if (p.lc != NULL) lc.update();
   }
 
-  zdd_t f = dd.evaluate(ToZBDD(setset::max_elem() - setset::num_elems()));
+  FrontierBasedSearch fbs(g, num_comps, no_loop, compact_states);
+  fbs.setPruning(lookahead_depth > 0);
+  FuseLinear(fbs, &p);
+
+  MessageHandler mh2;
+  mh2.begin("conversion") << " to ZBDD";
+  zdd_t f = dd.reduceAndEvaluate(
+      ToZBDD(setset::max_elem() - setset::num_elems()));
+  mh2.end();
+  mh.end();
   return setset(f);
 }
 
+setset SearchPaths(const vector<edge_t>& graph, const vertex_t& terminal1,
+                   const vertex_t& terminal2, bool is_hamilton,
+                   const setset* search_space) {
+  assert(terminal1 != terminal2);
+  const zdd_t* z = search_space != NULL ? &search_space->zdd_ : NULL;
+  return setset(SearchPathsOrCycles(graph, &terminal1, &terminal2,
+                                    is_hamilton, z));
+}
+
+setset SearchCycles(const vector<edge_t>& graph, bool is_hamilton,
+                    const setset* search_space) {
+  const zdd_t* z = search_space != NULL ? &search_space->zdd_ : NULL;
+  return setset(SearchPathsOrCycles(graph, NULL, NULL, is_hamilton, z));
+}
+
+vector<int> FrontierOrder(const vector<edge_t>& graph, int beam_width,
+                          const vertex_t* source) {
+  assert(beam_width >= 1);
+  Graph g;
+  for (vector<edge_t>::const_iterator e = graph.begin(); e != graph.end(); ++e)
+    g.addEdge(e->first, e->second);
+  g.update();
+  assert(static_cast<size_t>(g.edgeSize()) == graph.size());
+  int s = source != NULL ? g.getVertex(*source) : 0;
+  return g.frontierOrder(beam_width, s);
+}
+
+int MaxFrontierSize(const vector<edge_t>& graph) {
+  Graph g;
+  for (vector<edge_t>::const_iterator e = graph.begin(); e != graph.end(); ++e)
+    g.addEdge(e->first, e->second);
+  g.update();
+  return g.maxFrontierSize();
+}
+
 bool ShowMessages(bool flag) {
   return MessageHandler::showMessages(flag);
 }
 
+bool CompactStates(bool flag) {
+  bool prev = compact_states;
+  compact_states = flag;
+  return prev;
+}
+
+int Lookahead(int depth) {
+  int prev = lookahead_depth;
+  if (depth >= 0) lookahead_depth = depth;
+  return prev;
+}
+
+size_t SpillThreshold() {
+  return ZddStructure::spillThreshold();
+}
+
+size_t SpillThreshold(size_t bytes) {
+  return ZddStructure::spillThreshold(bytes);
+}
+
+size_t MinSpillThreshold(size_t bytes) {
+  return ZddStructure::minSpillThreshold(bytes);
+}
+
+ConstructionStats LastConstructionStats() {
+  const ZddStructure::Statistics& s = ZddStructure::lastStatistics();
+  ConstructionStats stats;
+  stats.num_nodes = s.numNodes;
+  stats.state_size = s.stateSize;
+  stats.num_threads = s.numThreads;
+  stats.spilled_size = s.spilledSize;
+  stats.merge_passes = s.mergePasses;
+  return stats;
+}
+
+int NumThreads(int num_threads) {
+#ifdef _OPENMP
+  int prev = omp_get_max_threads();
+  if (num_threads > 0) omp_set_num_threads(num_threads);
+  return prev;
+#else
+  return 1;
+#endif
+}
+
 }  // namespace graphillion
@@ -46,6 +46,10 @@ class Range : public IntSubset {
   int step_;
 };
 
+// Weights of `linear_constraints` that are all decimals with up to six
+// fractional digits, each exactly the double nearest to its decimal, are
+// summed as exact decimals; 0.1 + 0.2 thus meets an upper bound of 0.3.
+// Other weights are summed in floating point.
 setset SearchGraphs(
     const std::vector<edge_t>& graph,
     const std::vector<std::vector<vertex_t> >* vertex_groups = NULL,
@@ -56,8 +60,66 @@ setset SearchGraphs(
     const setset* search_space = NULL,
     const std::vector<linear_constraint_t>* linear_constraints = NULL);
 
+// Returns the paths between `terminal1` and `terminal2`, which must differ,
+// or the cycles, which pass through all vertices if `is_hamilton` is true.
+// They give the same results as SearchGraphs with the equivalent degree
+// constraints, but faster with a dedicated spec.  A loop has degree 2 and is
+// a cycle on its own, so it is never in a path.
+setset SearchPaths(const std::vector<edge_t>& graph, const vertex_t& terminal1,
+                   const vertex_t& terminal2, bool is_hamilton = false,
+                   const setset* search_space = NULL);
+setset SearchCycles(const std::vector<edge_t>& graph, bool is_hamilton = false,
+                    const setset* search_space = NULL);
+
+// Returns the indices of `graph` edges in an order that keeps the frontier
+// of SearchGraphs small; `source` is visited first if not NULL.
+std::vector<int> FrontierOrder(const std::vector<edge_t>& graph,
+                               int beam_width = 16,
+                               const vertex_t* source = NULL);
+
+// Returns the largest frontier SearchGraphs deals with on `graph`, which is
+// processed in the given order.
+int MaxFrontierSize(const std::vector<edge_t>& graph);
+
 bool ShowMessages(bool flag = true);
 
+// Makes SearchGraphs store frontier states bit-packed if `flag` is true,
+// which saves memory at the cost of time, and returns the setting before
+// the call.
+bool CompactStates(bool flag = true);
+
+// Sets the depth of lookahead in SearchGraphs if depth >= 0, and returns the
+// setting before the call.  States found dead within `depth` levels are
+// pruned; 0 disables lookahead (initial setting).
+int Lookahead(int depth = -1);
+
+// Sets the memory size in bytes for pending states in SearchGraphs, beyond
+// which they are spilled to a temporary file, and returns the setting before
+// the call.  0 keeps all states in memory (initial setting).
+size_t SpillThreshold();
+size_t SpillThreshold(size_t bytes);
+
+// Sets the lower limit to which smaller spill thresholds are raised, and
+// returns the setting before the call.  0 means the default of 128KB; a
+// lower limit also merges fewer runs at a time, which tests rely on.
+size_t MinSpillThreshold(size_t bytes);
+
+// Sets the number of threads used by SearchGraphs if num_threads > 0, and
+// returns the setting before the call; it is always 1 without OpenMP.
+int NumThreads(int num_threads = 0);
+
+// Statistics of the last construction by SearchGraphs, SearchPaths or
+// SearchCycles, for the settings above to be checked.
+struct ConstructionStats {
+  size_t num_nodes;       // nodes before reduction
+  int state_size;         // bytes of a state
+  int num_threads;        // threads used
+  uint64_t spilled_size;  // bytes spilled to a temporary file
+  int merge_passes;       // max passes merging the runs of a level
+};
+
+ConstructionStats LastConstructionStats();
+
 }  // namespace graphillion
 
 #endif  // GRAPHILLION_GRAPHSET_H_
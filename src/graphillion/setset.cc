@@ -50,7 +50,8 @@ using std::vector;
 setset::iterator::iterator() : zdd_(null()), s_(set<elem_t>()) {
 }
 
-setset::iterator::iterator(const setset::iterator& i) : zdd_(i.zdd_), s_(i.s_) {
+setset::iterator::iterator(const setset::iterator& i)
+    : zdd_(i.zdd_), s_(i.s_), path_(i.path_) {
 }
 
 setset::iterator::iterator(const setset& ss) : zdd_(ss.zdd_), s_(set<elem_t>()) {
@@ -66,22 +67,55 @@ setset::iterator& setset::iterator::operator++() {
   return *this;
 }
 
+// Advances along the path stack in the depth-first order taking hi branches
+// first, so that sets are yielded in the same order as choose() does.
 void setset::iterator::next() {
   if (this->zdd_ == null() || this->zdd_ == bot()) {
     this->zdd_ = null();
     this->s_ = set<elem_t>();
-  } else {
-    vector<elem_t> stack(this->s_.begin(), this->s_.end());
-    sort(stack.begin(), stack.end());
-    bool res = choose(this->zdd_, &stack);
-    if (res) {
-      this->s_ = set<elem_t>(stack.begin(), stack.end());
-      if (stack.size() == 0)  // reach to the empty set (the last)
+    this->path_.clear();
+    return;
+  }
+  zdd_t f = this->zdd_;
+  if (this->path_.empty()) {
+    if (this->s_.empty()) {  // start from the first set
+      this->descend(f);
+      if (this->s_.empty())  // reach to the empty set (the last)
         this->zdd_ = bot();
-    } else {
+      return;
+    }
+    set<elem_t> s;
+    while (!is_term(f)) {  // restore the path to the current set
+      bool b = this->s_.find(elem(f)) != this->s_.end();
+      this->path_.push_back(make_pair(f, b));
+      if (b) s.insert(s.end(), elem(f));
+      f = b ? hi(f) : lo(f);
+    }
+    this->s_ = s;
+  }
+  do {
+    while (!this->path_.empty() && !this->path_.back().second)
+      this->path_.pop_back();
+    if (this->path_.empty()) {
       this->zdd_ = null();
+      this->s_ = set<elem_t>();
+      return;
     }
+    this->path_.back().second = false;
+    this->s_.erase(--this->s_.end());
+    f = this->descend(lo(this->path_.back().first));
+  } while (f == bot());
+  if (this->s_.empty())  // reach to the empty set (the last)
+    this->zdd_ = bot();
+}
+
+zdd_t setset::iterator::descend(zdd_t f) {
+  while (!is_term(f)) {
+    this->path_.push_back(make_pair(f, true));
+    this->s_.insert(this->s_.end(), elem(f));
+    f = hi(f);
   }
+  return f;
 }
 
 setset::random_iterator::random_iterator() : iterator(), size_(0) {
@@ -139,9 +173,7 @@ void setset::weighted_iterator::next() {
 setset::setset() : zdd_(bot()) {
 }
 
-setset::setset(const vector<set<elem_t> >& v) : zdd_(bot()) {
-  for (vector<set<elem_t> >::const_iterator s = v.begin(); s != v.end(); ++s)
-    this->zdd_ += setset(*s).zdd_;
+setset::setset(const vector<set<elem_t> >& v) : zdd_(build(v)) {
 }
 
 setset::setset(const map<string, vector<elem_t> >& m) {
@@ -190,7 +222,7 @@ setset setset::operator-(const setset& ss) const {
 }
 
 setset setset::operator^(const setset& ss) const {
-  return setset((this->zdd_ - ss.zdd_) + (ss.zdd_ - this->zdd_));
+  return setset(symmetric_difference(this->zdd_, ss.zdd_));
 }
 
 setset setset::operator/(const setset& ss) const {
@@ -216,7 +248,7 @@ void setset::operator-=(const setset& ss) {
 }
 
 void setset::operator^=(const setset& ss) {
-  this->zdd_ = (this->zdd_ - ss.zdd_) + (ss.zdd_ - this->zdd_);
+  this->zdd_ = symmetric_difference(this->zdd_, ss.zdd_);
 }
 
 void setset::operator/=(const setset& ss) {
@@ -289,14 +321,20 @@ setset::weighted_iterator setset::begin_from_max(const vector<double>& weights)
 }
 
 setset::iterator setset::find(const set<elem_t>& s) const {
-  if (this->zdd_ - setset(s).zdd_ != this->zdd_)
+  if (graphillion::contains(this->zdd_, s))
     return setset::iterator(*this, s);
   else
     return setset::iterator();
 }
 
 size_t setset::count(const set<elem_t>& s) const {
-  return this->zdd_ / setset(s).zdd_ != bot() ? 1 : 0;
+  return graphillion::contains(this->zdd_, s) ? 1 : 0;
+}
+
+vector<bool> setset::contains(const vector<set<elem_t> >& sets) const {
+  vector<bool> found;
+  graphillion::contains(this->zdd_, sets, &found);
+  return found;
 }
 
 pair<setset::iterator, bool> setset::insert(const set<elem_t>& s) {
@@ -355,8 +393,7 @@ void setset::flip(elem_t e) {
 }
 
 void setset::flip() {
-  for (elem_t e = 1; e <= graphillion::num_elems(); ++e)
-    this->zdd_ = this->zdd_.Change(e);
+  this->zdd_ = graphillion::flip(this->zdd_);
 }
 
 setset setset::minimal() const {
@@ -380,16 +417,35 @@ setset setset::larger(size_t set_size) const {
 }
 
 setset setset::set_size(size_t set_size) const {
-  zdd_t z = this->zdd_.PermitSym(set_size) - this->zdd_.PermitSym(set_size - 1);
-  return setset(z);
+  return setset(this->zdd_.Slice(set_size));
+}
+
+vector<string> setset::size_histogram() const {
+  return graphillion::size_histogram(this->zdd_);
 }
 
-setset setset::join(const setset& ss) const {
-  return setset(graphillion::join(this->zdd_, ss.zdd_));
+setset setset::weight_range(const vector<double>& weights, double lower,
+                            double upper) const {
+  assert(weights.size() == static_cast<size_t>(num_elems() + 1));
+  return setset(graphillion::weight_range(this->zdd_, weights, lower, upper));
 }
 
-setset setset::meet(const setset& ss) const {
-  return setset(graphillion::meet(this->zdd_, ss.zdd_));
+setset setset::intersection_difference(const setset& g,
+                                       const setset& h) const {
+  return setset(graphillion::intersection_difference(this->zdd_, g.zdd_,
+                                                      h.zdd_));
+}
+
+setset setset::union_intersection(const setset& g, const setset& h) const {
+  return setset(graphillion::union_intersection(this->zdd_, g.zdd_, h.zdd_));
+}
+
+setset setset::join(const setset& ss, int num_threads, int cutoff) const {
+  return setset(graphillion::join(this->zdd_, ss.zdd_, num_threads, cutoff));
+}
+
+setset setset::meet(const setset& ss, int num_threads, int cutoff) const {
+  return setset(graphillion::meet(this->zdd_, ss.zdd_, num_threads, cutoff));
 }
 
 setset setset::subsets(const setset& ss) const {
@@ -439,12 +495,18 @@ double setset::probability(const vector<double>& probabilities) const {
   }
 }
 
-void setset::dump(ostream& out) const {
-  graphillion::dump(this->zdd_, out);
+void setset::dump(ostream& out, bool binary) const {
+  if (binary)
+    graphillion::dump_binary(this->zdd_, out);
+  else
+    graphillion::dump(this->zdd_, out);
 }
 
-void setset::dump(FILE* fp) const {
-  graphillion::dump(this->zdd_, fp);
+void setset::dump(FILE* fp, bool binary) const {
+  if (binary)
+    graphillion::dump_binary(this->zdd_, fp);
+  else
+    graphillion::dump(this->zdd_, fp);
 }
 
 setset setset::load(istream& in) {
@@ -455,6 +517,18 @@ setset setset::load(FILE* fp) {
   return setset(graphillion::load(fp));
 }
 
+void setset::dump_binary(string* out) const {
+  graphillion::dump_binary(this->zdd_, out);
+}
+
+bool setset::load_binary(const char* buf, size_t size, setset* ss) {
+  assert(ss != NULL);
+  zdd_t f = graphillion::load_binary(buf, size);
+  if (f == null()) return false;
+  ss->zdd_ = f;
+  return true;
+}
+
 void setset::_enum(ostream& out,
                    const pair<const char*, const char*> outer_braces,
                    const pair<const char*, const char*> inner_braces) const {
@@ -467,6 +541,17 @@ void setset::_enum(FILE* fp,
   graphillion::_enum(this->zdd_, fp, outer_braces, inner_braces);
 }
 
+size_t setset::visit(set_visitor* v, size_t offset, size_t limit) const {
+  return graphillion::visit(this->zdd_, v, offset, limit);
+}
+
+size_t setset::write_sets(FILE* fp, size_t offset, size_t limit) const {
+  binary_writer w(fp);
+  size_t n = graphillion::visit(this->zdd_, &w, offset, limit);
+  w.flush();
+  return n;
+}
+
 elem_t setset::elem_limit() {
   return graphillion::elem_limit();
 }
@@ -27,6 +27,7 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <map>
 #include <set>
 #include <string>
@@ -38,6 +39,7 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 namespace graphillion {
 
 class Range;
+class set_visitor;
 
 class setset {
  public:
@@ -58,9 +60,11 @@ class setset {
 
    protected:
     virtual void next();
+    zdd_t descend(zdd_t f);
 
     zdd_t zdd_;
     std::set<elem_t> s_;
+    std::vector<std::pair<zdd_t, bool> > path_;  // (node, taken hi branch)
   };
 
   typedef iterator const_iterator;
@@ -130,12 +134,14 @@ class setset {
 
   bool empty() const;
   std::string size() const;
+  std::vector<std::string> size_histogram() const;
   iterator begin() const;
   random_iterator begin_randomly() const;
   weighted_iterator begin_from_min(const std::vector<double>& weights) const;
   weighted_iterator begin_from_max(const std::vector<double>& weights) const;
   iterator find(const std::set<elem_t>& s) const;
   size_t count(const std::set<elem_t>& s) const;
+  std::vector<bool> contains(const std::vector<std::set<elem_t> >& sets) const;
   std::pair<iterator, bool> insert(const std::set<elem_t>& s);
   iterator insert(const_iterator hint, const std::set<elem_t>& s);
   void insert(elem_t e);
@@ -153,9 +159,14 @@ class setset {
   setset smaller(size_t set_size) const;
   setset larger(size_t set_size) const;
   setset set_size(size_t set_size) const;
-
-  setset join(const setset& ss) const;
-  setset meet(const setset& ss) const;
+  setset weight_range(const std::vector<double>& weights, double lower,
+                      double upper) const;
+
+  setset intersection_difference(const setset& g, const setset& h) const;
+  setset union_intersection(const setset& g, const setset& h) const;
+  // Uses num_threads tasks above recursion depth cutoff if num_threads > 1.
+  setset join(const setset& ss, int num_threads = 1, int cutoff = 8) const;
+  setset meet(const setset& ss, int num_threads = 1, int cutoff = 8) const;
   setset subsets(const setset& ss) const;
   setset supersets(const setset& ss) const;
   setset supersets(elem_t e) const;
@@ -165,10 +176,12 @@ class setset {
 
   double probability(const std::vector<double>& probabilities) const;
 
-  void dump(std::ostream& out) const;
-  void dump(FILE* fp = stdout) const;
+  void dump(std::ostream& out, bool binary = false) const;
+  void dump(FILE* fp = stdout, bool binary = false) const;
   static setset load(std::istream& in);
   static setset load(FILE* fp = stdin);
+  void dump_binary(std::string* out) const;
+  static bool load_binary(const char* buf, size_t size, setset* ss);
   void _enum(std::ostream& out,
              const std::pair<const char*, const char*> outer_braces
                = std::make_pair("{", "}"),
@@ -179,6 +192,10 @@ class setset {
                = std::make_pair("{", "}"),
              const std::pair<const char*, const char*> inner_braces
                = std::make_pair("{", "}")) const;
+  size_t visit(set_visitor* v, size_t offset = 0,
+               size_t limit = std::numeric_limits<size_t>::max()) const;
+  size_t write_sets(FILE* fp = stdout, size_t offset = 0,
+                    size_t limit = std::numeric_limits<size_t>::max()) const;
 
   static iterator end() { return iterator(); }
   static elem_t elem_limit();
@@ -196,6 +213,7 @@ class setset {
   zdd_t zdd_;
 
   friend class TestSetset;
+  friend class frozen_setset;
   friend setset SearchGraphs(
       const std::vector<edge_t>& graph,
       const std::vector<std::vector<vertex_t> >* vertex_groups,
@@ -205,6 +223,12 @@ class setset {
       bool no_loop,
       const setset* search_space,
       const std::vector<linear_constraint_t>* linear_constraints);
+  friend setset SearchPaths(const std::vector<edge_t>& graph,
+                            const vertex_t& terminal1,
+                            const vertex_t& terminal2, bool is_hamilton,
+                            const setset* search_space);
+  friend setset SearchCycles(const std::vector<edge_t>& graph,
+                             bool is_hamilton, const setset* search_space);
 };
 
 }  // namespace graphillion
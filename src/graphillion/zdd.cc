@@ -28,20 +28,32 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <climits>
 
 #include <algorithm>
+#include <limits>
 #include <map>
 #include <string>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "subsetting/util/BigNumber.hpp"
+
 namespace graphillion {
 
 using std::binary_search;
 using std::endl;
 using std::getline;
 using std::istream;
+using std::lower_bound;
+using std::make_pair;
 using std::map;
+using std::numeric_limits;
 using std::ostream;
 using std::pair;
 using std::set;
+using std::sort;
 using std::string;
+using std::unique;
 using std::vector;
 
 static const string WORD_FMT = "%lld";
@@ -102,14 +114,122 @@ zdd_t single(elem_t e) {
   return top().Change(e);
 }
 
-zdd_t complement(zdd_t f) {
-  vector<zdd_t> n(num_elems_ + 2);
-  n[0] = bot(), n[1] = top();
-  for (elem_t v = num_elems_; v > 0; --v) {
-    elem_t i = num_elems_ - v + 2;
-    n[i] = n[i - 1] + single(v) * n[i - 1];
+// Builds the sub-diagram for sets in [begin, end), which share the first
+// `depth` elements, walking the lexicographically sorted sets as a trie.
+static zdd_t build_sorted(const vector<vector<elem_t> >& v, size_t begin,
+                          size_t end, size_t depth) {
+  zdd_t f = bot();
+  if (v[begin].size() == depth) {  // the prefix itself comes first
+    f = top();
+    ++begin;
+  }
+  vector<size_t> groups;
+  for (size_t i = begin; i < end; ++i)
+    if (i == begin || v[i][depth] != v[i - 1][depth])
+      groups.push_back(i);
+  for (size_t i = groups.size(); i > 0; --i) {
+    size_t b = groups[i - 1];
+    size_t e = i < groups.size() ? groups[i] : end;
+    f = ZBDD_Node(v[b][depth], f, build_sorted(v, b, e, depth + 1));
+  }
+  return f;
+}
+
+zdd_t build(const vector<set<elem_t> >& sets) {
+  vector<vector<elem_t> > v;
+  v.reserve(sets.size());
+  elem_t e = 0;
+  for (vector<set<elem_t> >::const_iterator s = sets.begin();
+       s != sets.end(); ++s) {
+    v.push_back(vector<elem_t>(s->begin(), s->end()));
+    if (!s->empty()) {
+      assert(*s->begin() > 0);
+      e = std::max(e, *s->rbegin());
+    }
+  }
+  if (v.empty()) return bot();
+  new_elems(e);
+  sort(v.begin(), v.end());
+  v.erase(unique(v.begin(), v.end()), v.end());
+  return build_sorted(v, 0, v.size(), 0);
+}
+
+// Walks down f along s without making nodes; O(|s| + depth).
+bool contains(zdd_t f, const set<elem_t>& s) {
+  set<elem_t>::const_iterator e = s.begin();
+  while (!is_term(f)) {
+    if (e != s.end() && *e < elem(f)) return false;
+    if (e != s.end() && *e == elem(f)) {
+      f = hi(f);
+      ++e;
+    } else {
+      f = lo(f);
+    }
   }
-  return n[num_elems_ + 1] - f;
+  return e == s.end() && f == top();
+}
+
+// Answers candidates in [begin, end) of the sorted order, which share the
+// first `depth` elements already matched down to f.  Each group of
+// candidates with the same next element advances a single lo-walk.
+static void contains_sorted(zdd_t f, const vector<vector<elem_t> >& v,
+                            const vector<size_t>& order, size_t begin,
+                            size_t end, size_t depth, vector<bool>* found) {
+  if (v[order[begin]].size() == depth) {  // the prefix itself comes first
+    zdd_t g = f;
+    while (!is_term(g)) g = lo(g);
+    for (; begin < end && v[order[begin]].size() == depth; ++begin)
+      (*found)[order[begin]] = g == top();
+  }
+  while (begin < end) {
+    elem_t e = v[order[begin]][depth];
+    size_t i = begin;
+    while (i < end && v[order[i]][depth] == e) ++i;
+    while (!is_term(f) && elem(f) < e) f = lo(f);
+    if (!is_term(f) && elem(f) == e)
+      contains_sorted(hi(f), v, order, begin, i, depth + 1, found);
+    begin = i;
+  }
+}
+
+namespace {
+
+class set_less {
+ public:
+  explicit set_less(const vector<vector<elem_t> >& v) : v_(v) {}
+  bool operator()(size_t i, size_t j) const { return this->v_[i] < this->v_[j]; }
+
+ private:
+  const vector<vector<elem_t> >& v_;
+};
+
+}  // namespace
+
+void contains(zdd_t f, const vector<set<elem_t> >& sets, vector<bool>* found) {
+  assert(found != NULL);
+  found->assign(sets.size(), false);
+  if (sets.empty() || f == bot()) return;
+  vector<vector<elem_t> > v;
+  v.reserve(sets.size());
+  vector<size_t> order;
+  order.reserve(sets.size());
+  for (size_t i = 0; i < sets.size(); ++i) {
+    v.push_back(vector<elem_t>(sets[i].begin(), sets[i].end()));
+    order.push_back(i);
+  }
+  sort(order.begin(), order.end(), set_less(v));
+  contains_sorted(f, v, order, 0, order.size(), 0, found);
+}
+
+// Elements 1..num_elems_ occupy the levels above max_elem_ - num_elems_.
+zdd_t complement(zdd_t f) {
+  if (!initialized_) init();
+  return f.Complement(max_elem_ - num_elems_);
+}
+
+zdd_t flip(zdd_t f) {
+  if (!initialized_) init();
+  return f.ChangeAll(max_elem_ - num_elems_);
 }
 
 zdd_t minimal(zdd_t f) {
@@ -140,45 +260,140 @@ zdd_t maximal(zdd_t f) {
 
 zdd_t hitting(zdd_t f) {
   if (f == bot()) return top();
-  if (f == top()) return bot();
-  vector<vector<zdd_t> > stacks(num_elems_ + 1);
-  set<word_t> visited;
-  sort_zdd(f, &stacks, &visited);
-  map<word_t, zdd_t> cache;
-  cache[id(bot())] = bot();
-  cache[id(top())] = bot();
-  for (elem_t v = num_elems_; v > 0; --v) {
-    while (!stacks[v].empty()) {
-      zdd_t n = stacks[v].back();
-      stacks[v].pop_back();
-      zdd_t l = cache.at(id(lo(n)));
-      if (lo(n) != bot()) {
-        elem_t j = lo(n) == top() ? num_elems_ : elem(lo(n)) - 1;
-        for (; j > v; --j)
-          l = l + l.Change(j);
-      }
-      zdd_t h = cache.at(id(hi(n)));
-      if (hi(n) != bot()) {
-        elem_t j = hi(n) == top() ? num_elems_ : elem(hi(n)) - 1;
-        for (; j > v; --j)
-          h = h + h.Change(j);
-      }
-      if (lo(n) == bot()) {
-        zdd_t g = top();
-        for (elem_t j = num_elems_; j > v; --j)
-          g = g + g.Change(j);
-        g = g.Change(elem(n));
-        cache[id(n)] = h + g;
-      } else {
-        cache[id(n)] = (h & l) + l.Change(v);
-      }
-    }
+  return f.Hitting(max_elem_ - num_elems_);
+}
+
+// Returns the minimum and the maximum total weights of sets in f.
+static pair<double, double> weight_bounds(
+    zdd_t f, const vector<double>& weights,
+    map<word_t, pair<double, double> >* cache) {
+  assert(cache != NULL);
+  if (f == bot())
+    return make_pair(numeric_limits<double>::infinity(),
+                     -numeric_limits<double>::infinity());
+  if (f == top()) return make_pair(0.0, 0.0);
+  map<word_t, pair<double, double> >::iterator i = cache->find(id(f));
+  if (i != cache->end())
+    return i->second;
+  assert(static_cast<size_t>(elem(f)) < weights.size());
+  double w = weights[elem(f)];
+  pair<double, double> bl = weight_bounds(lo(f), weights, cache);
+  pair<double, double> bh = weight_bounds(hi(f), weights, cache);
+  pair<double, double> b(std::min(bl.first, bh.first + w),
+                         std::max(bl.second, bh.second + w));
+  return (*cache)[id(f)] = b;
+}
+
+// Residual bounds that no set in f can violate are replaced with infinity,
+// so that every residual bound in the same class shares a cache entry.
+static zdd_t weight_range(
+    zdd_t f, const vector<double>& weights, double lower, double upper,
+    map<word_t, pair<double, double> >* bounds,
+    map<pair<word_t, pair<double, double> >, zdd_t>* cache) {
+  assert(bounds != NULL && cache != NULL);
+  if (f == bot()) return bot();
+  pair<double, double> b = weight_bounds(f, weights, bounds);
+  if (b.second < lower || upper < b.first) return bot();
+  if (lower <= b.first && b.second <= upper) return f;
+  if (lower <= b.first) lower = -numeric_limits<double>::infinity();
+  if (b.second <= upper) upper = numeric_limits<double>::infinity();
+  pair<word_t, pair<double, double> > k
+      = make_pair(id(f), make_pair(lower, upper));
+  map<pair<word_t, pair<double, double> >, zdd_t>::iterator i = cache->find(k);
+  if (i != cache->end())
+    return i->second;
+  double w = weights[elem(f)];
+  zdd_t rl = weight_range(lo(f), weights, lower, upper, bounds, cache);
+  zdd_t rh = weight_range(hi(f), weights, lower - w, upper - w, bounds, cache);
+  return (*cache)[k] = zuniq(elem(f), rl, rh);
+}
+
+zdd_t weight_range(zdd_t f, const vector<double>& weights, double lower,
+                   double upper) {
+  map<word_t, pair<double, double> > bounds;
+  map<pair<word_t, pair<double, double> >, zdd_t> cache;
+  return weight_range(f, weights, lower, upper, &bounds, &cache);
+}
+
+zdd_t symmetric_difference(zdd_t f, zdd_t g) {
+  return ZBDD_SymDiff(f, g);
+}
+
+typedef map<pair<word_t, pair<word_t, word_t> >, zdd_t> ternary_cache_t;
+
+// Splits f by element v into the sets without v and those with v (v removed).
+static void split(zdd_t f, elem_t v, zdd_t* f0, zdd_t* f1) {
+  if (!is_term(f) && elem(f) == v) {
+    *f0 = lo(f);
+    *f1 = hi(f);
+  } else {
+    *f0 = f;
+    *f1 = bot();
   }
-  zdd_t g = cache.at(id(f));
-  elem_t j = is_term(f) ? num_elems_ : elem(f) - 1;
-  for (; j > 0; --j)
-    g = g + g.Change(j);
-  return g;
+}
+
+static elem_t top_elem(zdd_t f, zdd_t g, zdd_t h) {
+  elem_t v = numeric_limits<elem_t>::max();
+  if (!is_term(f)) v = std::min(v, elem(f));
+  if (!is_term(g)) v = std::min(v, elem(g));
+  if (!is_term(h)) v = std::min(v, elem(h));
+  return v;
+}
+
+static zdd_t intersection_difference(zdd_t f, zdd_t g, zdd_t h,
+                                     ternary_cache_t* cache) {
+  assert(cache != NULL);
+  if (f == bot() || g == bot()) return bot();
+  if (h == bot()) return f & g;
+  if (f == g) return f - h;
+  if (is_term(f) && is_term(g) && is_term(h)) return (f & g) - h;
+  if (id(g) < id(f)) std::swap(f, g);
+  pair<word_t, pair<word_t, word_t> > k
+      = make_pair(id(f), make_pair(id(g), id(h)));
+  ternary_cache_t::iterator i = cache->find(k);
+  if (i != cache->end()) return i->second;
+  elem_t v = top_elem(f, g, h);
+  zdd_t f0, f1, g0, g1, h0, h1;
+  split(f, v, &f0, &f1);
+  split(g, v, &g0, &g1);
+  split(h, v, &h0, &h1);
+  zdd_t r0 = intersection_difference(f0, g0, h0, cache);
+  zdd_t r1 = intersection_difference(f1, g1, h1, cache);
+  return (*cache)[k] = ZBDD_Node(v, r0, r1);
+}
+
+// Computes (f & g) - h in a single pass without materializing f & g.
+zdd_t intersection_difference(zdd_t f, zdd_t g, zdd_t h) {
+  ternary_cache_t cache;
+  return intersection_difference(f, g, h, &cache);
+}
+
+static zdd_t union_intersection(zdd_t f, zdd_t g, zdd_t h,
+                                ternary_cache_t* cache) {
+  assert(cache != NULL);
+  if (h == bot()) return bot();
+  if (f == bot()) return g & h;
+  if (g == bot() || f == g) return f & h;
+  if (is_term(f) && is_term(g) && is_term(h)) return (f + g) & h;
+  if (id(g) < id(f)) std::swap(f, g);
+  pair<word_t, pair<word_t, word_t> > k
+      = make_pair(id(f), make_pair(id(g), id(h)));
+  ternary_cache_t::iterator i = cache->find(k);
+  if (i != cache->end()) return i->second;
+  elem_t v = top_elem(f, g, h);
+  zdd_t f0, f1, g0, g1, h0, h1;
+  split(f, v, &f0, &f1);
+  split(g, v, &g0, &g1);
+  split(h, v, &h0, &h1);
+  zdd_t r0 = union_intersection(f0, g0, h0, cache);
+  zdd_t r1 = union_intersection(f1, g1, h1, cache);
+  return (*cache)[k] = ZBDD_Node(v, r0, r1);
+}
+
+// Computes (f | g) & h in a single pass without materializing f | g.
+zdd_t union_intersection(zdd_t f, zdd_t g, zdd_t h) {
+  ternary_cache_t cache;
+  return union_intersection(f, g, h, &cache);
 }
 
 zdd_t join(zdd_t f, zdd_t g) {
@@ -189,6 +404,303 @@ zdd_t meet(zdd_t f, zdd_t g) {
   return ZBDD_Meet(f, g);
 }
 
+namespace {
+
+#ifdef _OPENMP
+class table_lock {
+ public:
+  table_lock() { omp_init_lock(&lock_); }
+  ~table_lock() { omp_destroy_lock(&lock_); }
+  void acquire() { omp_set_lock(&lock_); }
+  void release() { omp_unset_lock(&lock_); }
+
+ private:
+  omp_lock_t lock_;
+};
+#else
+class table_lock {
+ public:
+  void acquire() {}
+  void release() {}
+};
+#endif
+
+// Node table shared by the tasks of parallel join and meet.  The kernel node
+// table is not thread-safe, so the operands are copied into this table, the
+// operation runs here, and the result is copied back.  Nodes are stored in
+// fixed-size chunks so that concurrent allocation never moves a node; the
+// unique and computed tables are striped by hash, each stripe with its lock.
+class parallel_table {
+ public:
+  typedef word_t (parallel_table::*op_t)(word_t, word_t, int);
+
+  explicit parallel_table(int cutoff);
+  ~parallel_table();
+
+  word_t copy(zdd_t f, map<word_t, word_t>* ids);
+  zdd_t to_zdd(word_t f) const;
+
+  word_t join(word_t f, word_t g, int depth);
+  word_t meet(word_t f, word_t g, int depth);
+  word_t unite(word_t f, word_t g, int depth);
+
+ private:
+  struct node {
+    elem_t v;
+    word_t lo;
+    word_t hi;
+  };
+
+  typedef pair<word_t, word_t> key_t;
+  typedef map<pair<elem_t, key_t>, word_t> unique_t;
+  typedef map<key_t, word_t> computed_t;
+
+  enum { JOIN, MEET, UNITE, NUM_OPS };
+  static const int CHUNK_BITS = 16;
+  static const word_t CHUNK_SIZE = static_cast<word_t>(1) << CHUNK_BITS;
+  static const size_t MAX_CHUNKS = 1 << 16;
+  static const size_t NUM_STRIPES = 64;
+
+  parallel_table(const parallel_table&);
+  void operator=(const parallel_table&);
+
+  const node& at(word_t f) const {
+    return this->chunks_[f >> CHUNK_BITS][f & (CHUNK_SIZE - 1)];
+  }
+  static size_t stripe(word_t f, word_t g) {
+    return (f * 31 + g) % NUM_STRIPES;
+  }
+  word_t make(elem_t v, word_t lo, word_t hi);
+  bool lookup(int op, word_t f, word_t g, word_t* r);
+  void store(int op, word_t f, word_t g, word_t r);
+  void apply(op_t op, const word_t* f, const word_t* g, word_t* r, int n,
+             int depth);
+
+  int cutoff_;
+  vector<node*> chunks_;
+  word_t size_;
+  table_lock alloc_lock_;
+  unique_t unique_[NUM_STRIPES];
+  table_lock unique_locks_[NUM_STRIPES];
+  computed_t computed_[NUM_OPS][NUM_STRIPES];
+  table_lock computed_locks_[NUM_STRIPES];
+};
+
+parallel_table::parallel_table(int cutoff)
+    : cutoff_(cutoff), chunks_(MAX_CHUNKS, static_cast<node*>(NULL)),
+      size_(2) {
+  this->chunks_[0] = new node[CHUNK_SIZE];
+  for (word_t f = 0; f < 2; ++f) {  // terminals sorted after all elements
+    this->chunks_[0][f].v = numeric_limits<elem_t>::max();
+    this->chunks_[0][f].lo = this->chunks_[0][f].hi = f;
+  }
+}
+
+parallel_table::~parallel_table() {
+  for (size_t i = 0; i < MAX_CHUNKS && this->chunks_[i] != NULL; ++i)
+    delete[] this->chunks_[i];
+}
+
+word_t parallel_table::make(elem_t v, word_t lo, word_t hi) {
+  if (hi == 0) return lo;
+  pair<elem_t, key_t> k = make_pair(v, make_pair(lo, hi));
+  size_t i = stripe(lo, hi);
+  this->unique_locks_[i].acquire();
+  unique_t::const_iterator u = this->unique_[i].find(k);
+  word_t f;
+  if (u != this->unique_[i].end()) {
+    f = u->second;
+  } else {
+    this->alloc_lock_.acquire();
+    f = this->size_++;
+    assert((f >> CHUNK_BITS) < MAX_CHUNKS);
+    node*& chunk = this->chunks_[f >> CHUNK_BITS];
+    if (chunk == NULL) chunk = new node[CHUNK_SIZE];
+    this->alloc_lock_.release();
+    node& n = chunk[f & (CHUNK_SIZE - 1)];
+    n.v = v;
+    n.lo = lo;
+    n.hi = hi;
+    this->unique_[i][k] = f;
+  }
+  this->unique_locks_[i].release();
+  return f;
+}
+
+bool parallel_table::lookup(int op, word_t f, word_t g, word_t* r) {
+  size_t i = stripe(f, g);
+  this->computed_locks_[i].acquire();
+  computed_t::const_iterator c = this->computed_[op][i].find(make_pair(f, g));
+  bool found = c != this->computed_[op][i].end();
+  if (found) *r = c->second;
+  this->computed_locks_[i].release();
+  return found;
+}
+
+void parallel_table::store(int op, word_t f, word_t g, word_t r) {
+  size_t i = stripe(f, g);
+  this->computed_locks_[i].acquire();
+  this->computed_[op][i][make_pair(f, g)] = r;
+  this->computed_locks_[i].release();
+}
+
+// Computes r[i] = op(f[i], g[i]) for i < n, as tasks above the cutoff depth.
+void parallel_table::apply(op_t op, const word_t* f, const word_t* g,
+                           word_t* r, int n, int depth) {
+  if (depth < this->cutoff_) {
+    for (int i = 0; i < n; ++i) {
+#ifdef _OPENMP
+#pragma omp task
+#endif
+      r[i] = (this->*op)(f[i], g[i], depth + 1);
+    }
+#ifdef _OPENMP
+#pragma omp taskwait
+#endif
+  } else {
+    for (int i = 0; i < n; ++i)
+      r[i] = (this->*op)(f[i], g[i], depth + 1);
+  }
+}
+
+word_t parallel_table::copy(zdd_t f, map<word_t, word_t>* ids) {
+  if (f == bot()) return 0;
+  if (f == top()) return 1;
+  map<word_t, word_t>::const_iterator i = ids->find(id(f));
+  if (i != ids->end()) return i->second;
+  word_t l = this->copy(lo(f), ids);
+  word_t h = this->copy(hi(f), ids);
+  return (*ids)[id(f)] = this->make(elem(f), l, h);
+}
+
+zdd_t parallel_table::to_zdd(word_t f) const {
+  vector<word_t> nodes;
+  set<word_t> visited;
+  vector<word_t> stack(1, f);
+  while (!stack.empty()) {
+    word_t g = stack.back();
+    stack.pop_back();
+    if (g < 2 || !visited.insert(g).second) continue;
+    nodes.push_back(g);
+    stack.push_back(this->at(g).lo);
+    stack.push_back(this->at(g).hi);
+  }
+  sort(nodes.begin(), nodes.end());  // children are made before parents
+  map<word_t, zdd_t> zdds;
+  zdds[0] = bot();
+  zdds[1] = top();
+  for (vector<word_t>::const_iterator i = nodes.begin(); i != nodes.end();
+       ++i) {
+    const node& n = this->at(*i);
+    zdds[*i] = ZBDD_Node(n.v, zdds[n.lo], zdds[n.hi]);
+  }
+  return zdds[f];
+}
+
+word_t parallel_table::unite(word_t f, word_t g, int depth) {
+  if (f == 0 || f == g) return g;
+  if (g == 0) return f;
+  if (f > g) std::swap(f, g);
+  word_t r;
+  if (this->lookup(UNITE, f, g, &r)) return r;
+  if (this->at(g).v < this->at(f).v) std::swap(f, g);
+  const node a = this->at(f);
+  const node b = this->at(g);
+  if (a.v < b.v) {
+    r = this->make(a.v, this->unite(a.lo, g, depth + 1), a.hi);
+  } else {
+    word_t fs[] = {a.lo, a.hi};
+    word_t gs[] = {b.lo, b.hi};
+    word_t rs[2];
+    this->apply(&parallel_table::unite, fs, gs, rs, 2, depth);
+    r = this->make(a.v, rs[0], rs[1]);
+  }
+  this->store(UNITE, std::min(f, g), std::max(f, g), r);
+  return r;
+}
+
+word_t parallel_table::join(word_t f, word_t g, int depth) {
+  if (f == 0 || g == 0) return 0;
+  if (f == 1) return g;
+  if (g == 1) return f;
+  if (f > g) std::swap(f, g);
+  word_t r;
+  if (this->lookup(JOIN, f, g, &r)) return r;
+  if (this->at(g).v < this->at(f).v) std::swap(f, g);
+  const node a = this->at(f);
+  const node b = this->at(g);
+  if (a.v < b.v) {
+    word_t fs[] = {a.lo, a.hi};
+    word_t gs[] = {g, g};
+    word_t rs[2];
+    this->apply(&parallel_table::join, fs, gs, rs, 2, depth);
+    r = this->make(a.v, rs[0], rs[1]);
+  } else {
+    word_t fs[] = {a.lo, a.hi, a.hi, a.lo};
+    word_t gs[] = {b.lo, b.hi, b.lo, b.hi};
+    word_t rs[4];
+    this->apply(&parallel_table::join, fs, gs, rs, 4, depth);
+    word_t h = this->unite(this->unite(rs[1], rs[2], depth), rs[3], depth);
+    r = this->make(a.v, rs[0], h);
+  }
+  this->store(JOIN, std::min(f, g), std::max(f, g), r);
+  return r;
+}
+
+word_t parallel_table::meet(word_t f, word_t g, int depth) {
+  if (f == 0 || g == 0) return 0;
+  if (f == 1 || g == 1) return 1;
+  if (f > g) std::swap(f, g);
+  word_t r;
+  if (this->lookup(MEET, f, g, &r)) return r;
+  if (this->at(g).v < this->at(f).v) std::swap(f, g);
+  const node a = this->at(f);
+  const node b = this->at(g);
+  if (a.v < b.v) {
+    word_t fs[] = {a.lo, a.hi};
+    word_t gs[] = {g, g};
+    word_t rs[2];
+    this->apply(&parallel_table::meet, fs, gs, rs, 2, depth);
+    r = this->unite(rs[0], rs[1], depth);
+  } else {
+    word_t fs[] = {a.hi, a.lo, a.hi, a.lo};
+    word_t gs[] = {b.hi, b.lo, b.lo, b.hi};
+    word_t rs[4];
+    this->apply(&parallel_table::meet, fs, gs, rs, 4, depth);
+    word_t l = this->unite(this->unite(rs[1], rs[2], depth), rs[3], depth);
+    r = this->make(a.v, l, rs[0]);
+  }
+  this->store(MEET, std::min(f, g), std::max(f, g), r);
+  return r;
+}
+
+zdd_t parallel_apply(parallel_table::op_t op, zdd_t f, zdd_t g,
+                     int num_threads, int cutoff) {
+  parallel_table table(cutoff);
+  map<word_t, word_t> ids;
+  word_t fx = table.copy(f, &ids);
+  word_t gx = table.copy(g, &ids);
+  word_t r = 0;
+#ifdef _OPENMP
+#pragma omp parallel num_threads(num_threads)
+#pragma omp single
+#endif
+  r = (table.*op)(fx, gx, 0);
+  return table.to_zdd(r);
+}
+
+}  // namespace
+
+zdd_t join(zdd_t f, zdd_t g, int num_threads, int cutoff) {
+  if (num_threads <= 1) return join(f, g);
+  return parallel_apply(&parallel_table::join, f, g, num_threads, cutoff);
+}
+
+zdd_t meet(zdd_t f, zdd_t g, int num_threads, int cutoff) {
+  if (num_threads <= 1) return meet(f, g);
+  return parallel_apply(&parallel_table::meet, f, g, num_threads, cutoff);
+}
+
 zdd_t non_subsets(zdd_t f, zdd_t g) {
   static map<pair<word_t, word_t>, zdd_t> cache;
   if (g == bot())
@@ -325,6 +837,236 @@ zdd_t choose_best(zdd_t f, const vector<double>& weights, set<elem_t>* s) {
   return g;
 }
 
+namespace {
+
+// Binary format, version 1:
+//   magic "\x89ZDD", then varints: version, flags, number of elements,
+//   number of nodes n; a terminal (0 or 1) if n is 0.
+//   Nodes follow from the bottom level as varint triples: the element as a
+//   decrease from the previous node (from the number of elements for the
+//   first), and the lo and hi children.  A child is 0 or 1 for a terminal,
+//   or k + 1 for the node k places before the current one.
+//   If flags has BINARY_CHECKSUM, a 32-bit FNV-1a hash of all the preceding
+//   bytes follows in little endian.
+const char BINARY_MAGIC[] = "\x89ZDD";
+const word_t BINARY_VERSION = 1;
+const word_t BINARY_CHECKSUM = 1;
+const uint32_t FNV_OFFSET = 2166136261U;
+const uint32_t FNV_PRIME = 16777619U;
+
+class binary_sink {
+ public:
+  explicit binary_sink(FILE* fp)
+      : fp_(fp), out_(NULL), str_(NULL), hash_(FNV_OFFSET) {}
+  explicit binary_sink(ostream& out)
+      : fp_(NULL), out_(&out), str_(NULL), hash_(FNV_OFFSET) {}
+  explicit binary_sink(string* str)
+      : fp_(NULL), out_(NULL), str_(str), hash_(FNV_OFFSET) {}
+  ~binary_sink() { this->flush(); }
+
+  void put(unsigned char c) {
+    this->buf_.push_back(c);
+    this->hash_ = (this->hash_ ^ c) * FNV_PRIME;
+    if (this->buf_.size() >= 1 << 16) this->flush();
+  }
+  void put_varint(word_t x) {
+    for (; x >= 0x80; x >>= 7)
+      this->put(static_cast<unsigned char>(x | 0x80));
+    this->put(static_cast<unsigned char>(x));
+  }
+  void flush() {
+    if (this->buf_.empty()) return;
+    if (this->fp_ != NULL)
+      fwrite(&this->buf_[0], 1, this->buf_.size(), this->fp_);
+    else if (this->out_ != NULL)
+      this->out_->write(&this->buf_[0], this->buf_.size());
+    else
+      this->str_->append(this->buf_.begin(), this->buf_.end());
+    this->buf_.clear();
+  }
+  uint32_t hash() const { return this->hash_; }
+
+ private:
+  FILE* fp_;
+  ostream* out_;
+  string* str_;
+  vector<char> buf_;
+  uint32_t hash_;
+};
+
+class binary_source {
+ public:
+  explicit binary_source(FILE* fp)
+      : fp_(fp), in_(NULL), buf_(NULL), end_(NULL), hash_(FNV_OFFSET) {}
+  explicit binary_source(istream& in)
+      : fp_(NULL), in_(&in), buf_(NULL), end_(NULL), hash_(FNV_OFFSET) {}
+  binary_source(const char* buf, size_t size)
+      : fp_(NULL), in_(NULL), buf_(buf), end_(buf + size),
+        hash_(FNV_OFFSET) {}
+
+  bool get(unsigned char* c) {
+    if (this->buf_ != NULL) {
+      if (this->buf_ == this->end_) return false;
+      *c = static_cast<unsigned char>(*this->buf_++);
+    } else {
+      int x = this->fp_ != NULL ? getc(this->fp_) : this->in_->get();
+      if (x == EOF) return false;
+      *c = static_cast<unsigned char>(x);
+    }
+    this->hash_ = (this->hash_ ^ *c) * FNV_PRIME;
+    return true;
+  }
+  bool get_varint(word_t* x) {
+    *x = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      unsigned char c;
+      if (!this->get(&c)) return false;
+      *x |= static_cast<word_t>(c & 0x7f) << shift;
+      if (!(c & 0x80)) return true;
+    }
+    return false;
+  }
+  bool at_end() const { return this->buf_ != NULL && this->buf_ == this->end_; }
+  uint32_t hash() const { return this->hash_; }
+
+ private:
+  FILE* fp_;
+  istream* in_;
+  const char* buf_;
+  const char* end_;
+  uint32_t hash_;
+};
+
+void dump_binary(zdd_t f, binary_sink* out, bool checksum) {
+  for (int i = 0; i < 4; ++i) out->put(BINARY_MAGIC[i]);
+  out->put_varint(BINARY_VERSION);
+  out->put_varint(checksum ? BINARY_CHECKSUM : 0);
+  out->put_varint(num_elems_);
+  if (is_term(f)) {
+    out->put_varint(0);
+    out->put_varint(f == top() ? 1 : 0);
+  } else {
+    vector<vector<zdd_t> > stacks(num_elems_ + 1);
+    set<word_t> visited;
+    sort_zdd(f, &stacks, &visited);
+    out->put_varint(visited.size());
+    vector<pair<word_t, word_t> > index;  // sorted (node id, position)
+    index.reserve(visited.size() + 2);
+    index.push_back(make_pair(id(bot()), 0));
+    index.push_back(make_pair(id(top()), 1));
+    word_t k = 2;
+    for (elem_t v = num_elems_; v > 0; --v)
+      for (vector<zdd_t>::const_iterator i = stacks[v].begin();
+           i != stacks[v].end(); ++i)
+        index.push_back(make_pair(id(*i), k++));
+    sort(index.begin(), index.end());
+    k = 2;
+    elem_t prev = num_elems_;
+    for (elem_t v = num_elems_; v > 0; --v) {
+      for (vector<zdd_t>::const_iterator i = stacks[v].begin();
+           i != stacks[v].end(); ++i, ++k) {
+        out->put_varint(prev - v);
+        prev = v;
+        zdd_t c[] = {lo(*i), hi(*i)};
+        for (int j = 0; j < 2; ++j) {
+          word_t x = lower_bound(index.begin(), index.end(),
+                                 make_pair(id(c[j]), word_t(0)))->second;
+          out->put_varint(x < 2 ? x : k - x + 1);
+        }
+      }
+    }
+  }
+  if (checksum) {
+    uint32_t hash = out->hash();
+    for (int i = 0; i < 4; ++i, hash >>= 8)
+      out->put(static_cast<unsigned char>(hash & 0xff));
+  }
+}
+
+// Returns null() if the input is malformed; nodes are created directly in the
+// unique table, so the level order is checked before each one is made.
+zdd_t load_binary(binary_source* in) {
+  for (int i = 0; i < 4; ++i) {
+    unsigned char c;
+    if (!in->get(&c) || c != static_cast<unsigned char>(BINARY_MAGIC[i]))
+      return null();
+  }
+  word_t version, flags, nelems, n;
+  if (!in->get_varint(&version) || version != BINARY_VERSION) return null();
+  if (!in->get_varint(&flags) || (flags & ~BINARY_CHECKSUM)) return null();
+  if (!in->get_varint(&nelems) ||
+      nelems > static_cast<word_t>(elem_limit()))
+    return null();
+  if (!in->get_varint(&n)) return null();
+  zdd_t f;
+  if (n == 0) {
+    word_t t;
+    if (!in->get_varint(&t) || t > 1) return null();
+    f = t == 1 ? top() : bot();
+  } else {
+    vector<zdd_t> nodes;
+    vector<elem_t> elems;
+    nodes.push_back(bot());
+    nodes.push_back(top());
+    elems.push_back(numeric_limits<elem_t>::max());
+    elems.push_back(numeric_limits<elem_t>::max());
+    word_t prev = nelems;
+    for (word_t k = 2; k < n + 2; ++k) {
+      word_t d, r[2];
+      if (!in->get_varint(&d) || d >= prev) return null();
+      if (!in->get_varint(&r[0]) || !in->get_varint(&r[1])) return null();
+      elem_t v = static_cast<elem_t>(prev - d);
+      prev = v;
+      if (k == 2) new_elems(v);
+      for (int j = 0; j < 2; ++j) {
+        if (r[j] < 2) continue;
+        if (r[j] > k - 1) return null();
+        r[j] = k - r[j] + 1;
+        if (elems[r[j]] <= v) return null();
+      }
+      if (r[1] == 0) return null();
+      nodes.push_back(ZBDD_Node(v, nodes[r[0]], nodes[r[1]]));
+      elems.push_back(v);
+    }
+    f = nodes.back();
+  }
+  if (flags & BINARY_CHECKSUM) {
+    uint32_t hash = in->hash();
+    uint32_t x = 0;
+    for (int i = 0; i < 4; ++i) {
+      unsigned char c;
+      if (!in->get(&c)) return null();
+      x |= static_cast<uint32_t>(c) << (8 * i);
+    }
+    if (x != hash) return null();
+  }
+  return f;
+}
+
+}  // namespace
+
+void dump_binary(zdd_t f, ostream& out, bool checksum) {
+  binary_sink sink(out);
+  dump_binary(f, &sink, checksum);
+}
+
+void dump_binary(zdd_t f, FILE* fp, bool checksum) {
+  binary_sink sink(fp);
+  dump_binary(f, &sink, checksum);
+}
+
+void dump_binary(zdd_t f, string* out, bool checksum) {
+  assert(out != NULL);
+  binary_sink sink(out);
+  dump_binary(f, &sink, checksum);
+}
+
+zdd_t load_binary(const char* buf, size_t size) {
+  binary_source source(buf, size);
+  zdd_t f = load_binary(&source);
+  return source.at_end() ? f : null();
+}
+
 void dump(zdd_t f, ostream& out) {
   if (f == bot()) {
     out << "B" << endl;
@@ -386,6 +1128,12 @@ void dump(zdd_t f, FILE* fp) {
 }
 
 zdd_t load(istream& in) {
+  if (in.peek() == static_cast<unsigned char>(BINARY_MAGIC[0])) {
+    binary_source source(in);
+    zdd_t f = load_binary(&source);
+    if (f == null()) in.setstate(in.badbit);
+    return f;
+  }
   string line;
   getline(in, line);
   if      (line == "B") return bot();
@@ -419,6 +1167,13 @@ error:
 }
 
 zdd_t load(FILE* fp) {
+  int c = getc(fp);
+  if (c == EOF) return null();
+  ungetc(c, fp);
+  if (c == static_cast<unsigned char>(BINARY_MAGIC[0])) {
+    binary_source source(fp);
+    return load_binary(&source);
+  }
   char buf[256];
   if (fgets(buf, sizeof(buf), fp) == NULL) return null();
   string line = buf;
@@ -450,67 +1205,213 @@ zdd_t load(FILE* fp) {
   return root;
 }
 
+namespace {
+
+// Formats sets like "{1, 2}" into a reused buffer and hands it to write().
+class text_visitor : public set_visitor {
+ public:
+  explicit text_visitor(const pair<const char*, const char*>& inner_braces)
+      : inner_braces_(inner_braces), first_(true) {
+  }
+
+  virtual bool operator()(const elem_t* elems, size_t size) {
+    this->buf_.clear();
+    if (this->first_)
+      this->first_ = false;
+    else
+      this->buf_ += ", ";
+    this->buf_ += this->inner_braces_.first;
+    for (size_t i = 0; i < size; ++i) {
+      if (i > 0) this->buf_ += ", ";
+      char s[16];
+      int n = snprintf(s, sizeof(s), "%d", elems[i]);
+      this->buf_.append(s, n);
+    }
+    this->buf_ += this->inner_braces_.second;
+    return this->write(this->buf_);
+  }
+
+ protected:
+  virtual bool write(const string& s) = 0;
+
+ private:
+  const pair<const char*, const char*>& inner_braces_;
+  bool first_;
+  string buf_;
+};
+
+class ostream_visitor : public text_visitor {
+ public:
+  ostream_visitor(ostream& out,
+                  const pair<const char*, const char*>& inner_braces)
+      : text_visitor(inner_braces), out_(out) {
+  }
+
+ protected:
+  virtual bool write(const string& s) {
+    this->out_.write(s.data(), s.size());
+    return this->out_.good();
+  }
+
+ private:
+  ostream& out_;
+};
+
+class file_visitor : public text_visitor {
+ public:
+  file_visitor(FILE* fp, const pair<const char*, const char*>& inner_braces)
+      : text_visitor(inner_braces), fp_(fp) {
+  }
+
+ protected:
+  virtual bool write(const string& s) {
+    return fwrite(s.data(), 1, s.size(), this->fp_) == s.size();
+  }
+
+ private:
+  FILE* fp_;
+};
+
+}  // namespace
+
+binary_writer::binary_writer(FILE* fp, size_t buf_size)
+    : fp_(fp), good_(true) {
+  assert(fp != NULL);
+  this->buf_.reserve(buf_size / sizeof(elem_t));
+}
+
+binary_writer::~binary_writer() {
+  this->flush();
+}
+
+bool binary_writer::operator()(const elem_t* elems, size_t size) {
+  if (this->buf_.size() + size + 1 > this->buf_.capacity())
+    this->flush();
+  this->buf_.push_back(static_cast<elem_t>(size));
+  this->buf_.insert(this->buf_.end(), elems, elems + size);
+  return this->good_;
+}
+
+bool binary_writer::flush() {
+  if (!this->buf_.empty() &&
+      fwrite(&this->buf_[0], sizeof(elem_t), this->buf_.size(), this->fp_)
+      != this->buf_.size())
+    this->good_ = false;
+  this->buf_.clear();
+  return this->good_;
+}
+
+// Visits sets in the same order as the former recursive enumeration, hi
+// branches first, with an explicit stack of (node, in hi branch) frames.
+// Sub-diagrams entirely covered by the offset are skipped by their counts.
+size_t visit(zdd_t f, set_visitor* v, size_t offset, size_t limit) {
+  assert(v != NULL);
+  vector<pair<zdd_t, bool> > stack;
+  vector<elem_t> elems;
+  size_t n = 0;
+  zdd_t g = f;
+  while (n < limit) {
+    while (!is_term(g)) {
+      if (offset > 0) {
+        double c = algo_c(g);
+        if (c <= offset) {
+          offset -= static_cast<size_t>(c);
+          g = bot();
+          break;
+        }
+      }
+      stack.push_back(make_pair(g, true));
+      elems.push_back(elem(g));
+      g = hi(g);
+    }
+    if (g == top()) {
+      if (offset > 0) {
+        --offset;
+      } else {
+        ++n;
+        if (!(*v)(elems.empty() ? NULL : &elems[0], elems.size())) break;
+      }
+    }
+    while (!stack.empty() && !stack.back().second)
+      stack.pop_back();
+    if (stack.empty()) break;
+    stack.back().second = false;
+    elems.pop_back();
+    g = lo(stack.back().first);
+  }
+  return n;
+}
+
 void _enum(zdd_t f, ostream& out,
            const pair<const char*, const char*>& outer_braces,
            const pair<const char*, const char*>& inner_braces) {
-  vector<elem_t> stack;
   out << outer_braces.first;
-  bool first = true;
-  _enum(f, out, &stack, &first, inner_braces);
+  ostream_visitor v(out, inner_braces);
+  visit(f, &v);
   out << outer_braces.second;
-  if (out == std::cout || out == std::cerr)
+  if (&out == &std::cout || &out == &std::cerr)
     out << endl;
 }
 
 void _enum(zdd_t f, FILE* fp,
            const pair<const char*, const char*>& outer_braces,
            const pair<const char*, const char*>& inner_braces) {
-  vector<elem_t> stack;
   fprintf(fp, "%s", outer_braces.first);
-  bool first = true;
-  _enum(f, fp, &stack, &first, inner_braces);
+  file_visitor v(fp, inner_braces);
+  visit(f, &v);
   fprintf(fp, "%s", outer_braces.second);
   if (fp == stdout || fp == stderr)
     fprintf(fp, "\n");
 }
 
-void _enum(zdd_t f, ostream& out, vector<elem_t>* stack, bool* first,
-           const pair<const char*, const char*>& inner_braces) {
-  assert(stack != NULL);
-  if (is_term(f)) {
-    if (f == top()) {
-      if (*first)
-        *first = false;
-      else
-        out << ", ";
-      out << inner_braces.first << join(*stack, ", ") << inner_braces.second;
+// Counts sets by their sizes with the polynomial DP
+// hist(f)[k] = hist(lo(f))[k] + hist(hi(f))[k - 1], bottom up.  Each count
+// is a BigNumber in a fixed-width slot, and a node's histogram is released
+// once all of its parents are done.
+vector<string> size_histogram(zdd_t f) {
+  if (!initialized_) init();
+  vector<string> counts;
+  if (f == bot()) return counts;
+  size_t w = max_elem_ / 63 + 2;  // words enough for any count
+  vector<vector<zdd_t> > stacks(max_elem_ + 1);
+  set<word_t> visited;
+  sort_zdd(f, &stacks, &visited);
+  map<word_t, int> parents;
+  for (elem_t v = max_elem_; v > 0; --v) {
+    for (vector<zdd_t>::const_iterator n = stacks[v].begin();
+         n != stacks[v].end(); ++n) {
+      ++parents[id(lo(*n))];
+      ++parents[id(hi(*n))];
     }
-    return;
   }
-  stack->push_back(elem(f));
-  _enum(hi(f), out, stack, first, inner_braces);
-  stack->pop_back();
-  _enum(lo(f), out, stack, first, inner_braces);
-}
-
-void _enum(zdd_t f, FILE* fp, vector<elem_t>* stack, bool* first,
-           const pair<const char*, const char*>& inner_braces) {
-  assert(stack != NULL);
-  if (is_term(f)) {
-    if (f == top()) {
-      if (*first)
-        *first = false;
-      else
-        fprintf(fp, ", ");
-      fprintf(fp, "%s%s%s", inner_braces.first, join(*stack, ", ").c_str(),
-              inner_braces.second);
+  map<word_t, vector<uint64_t> > hists;
+  hists[id(bot())] = vector<uint64_t>();
+  hists[id(top())] = vector<uint64_t>(w, 0);
+  BigNumber(&hists[id(top())][0]).store(1);
+  for (elem_t v = max_elem_; v > 0; --v) {
+    for (vector<zdd_t>::const_iterator n = stacks[v].begin();
+         n != stacks[v].end(); ++n) {
+      vector<uint64_t>& l = hists.at(id(lo(*n)));
+      vector<uint64_t>& h = hists.at(id(hi(*n)));
+      size_t ll = l.size() / w, hl = h.size() / w;
+      vector<uint64_t> r(std::max(ll, hl + 1) * w, 0);
+      for (size_t k = 0; k < r.size() / w; ++k) {
+        BigNumber x(&r[k * w]);
+        x.store(0);
+        if (k < ll) x.add(BigNumber(&l[k * w]));
+        if (k > 0 && k - 1 < hl) x.add(BigNumber(&h[(k - 1) * w]));
+      }
+      hists[id(*n)].swap(r);
+      if (!is_term(lo(*n)) && --parents[id(lo(*n))] == 0)
+        hists.erase(id(lo(*n)));
+      if (!is_term(hi(*n)) && --parents[id(hi(*n))] == 0)
+        hists.erase(id(hi(*n)));
     }
-    return;
   }
-  stack->push_back(elem(f));
-  _enum(hi(f), fp, stack, first, inner_braces);
-  stack->pop_back();
-  _enum(lo(f), fp, stack, first, inner_braces);
+  vector<uint64_t>& r = hists.at(id(f));
+  for (size_t k = 0; k < r.size() / w; ++k)
+    counts.push_back(BigNumber(&r[k * w]));
+  return counts;
 }
 
 // Algorithm B modified for ZDD, from Knuth vol. 4 fascicle 1 sec. 7.1.4.
@@ -25,9 +25,12 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #ifndef GRAPHILLION_ZDD_H_
 #define GRAPHILLION_ZDD_H_
 
+#include <cstdio>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <set>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -36,6 +39,32 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 namespace graphillion {
 
+// Receives sets enumerated by visit().
+class set_visitor {
+ public:
+  virtual ~set_visitor() {}
+
+  // Called for each set with its elements in ascending order.  The buffer is
+  // reused for the next set, so copy it if needed.  Returns false to stop.
+  virtual bool operator()(const elem_t* elems, size_t size) = 0;
+};
+
+// Writes each set as a 32-bit size followed by its elements in the host byte
+// order.  Output is buffered and flushed on destruction.
+class binary_writer : public set_visitor {
+ public:
+  explicit binary_writer(FILE* fp, size_t buf_size = 1 << 16);
+  virtual ~binary_writer();
+
+  virtual bool operator()(const elem_t* elems, size_t size);
+  bool flush();
+
+ private:
+  FILE* fp_;
+  std::vector<elem_t> buf_;
+  bool good_;
+};
+
 void init();
 elem_t elem_limit();
 elem_t max_elem();
@@ -44,6 +73,10 @@ elem_t num_elems();
 void num_elems(elem_t num_elems);
 
 zdd_t single(elem_t e);
+zdd_t build(const std::vector<std::set<elem_t> >& sets);
+bool contains(zdd_t f, const std::set<elem_t>& s);
+void contains(zdd_t f, const std::vector<std::set<elem_t> >& sets,
+              std::vector<bool>* found);
 inline word_t id(zdd_t f) { return f.GetID(); }
 inline zdd_t null() { return zdd_t(-1); }
 inline zdd_t bot() { return zdd_t(0); }
@@ -65,11 +98,19 @@ inline elem_t elem(zdd_t f) {
 zdd_t operator|(const zdd_t& f, const zdd_t& g);
 
 zdd_t complement(zdd_t f);
+zdd_t flip(zdd_t f);
 zdd_t minimal(zdd_t f);
 zdd_t maximal(zdd_t f);
 zdd_t hitting(zdd_t f);
+zdd_t weight_range(zdd_t f, const std::vector<double>& weights, double lower,
+                   double upper);
+zdd_t symmetric_difference(zdd_t f, zdd_t g);
+zdd_t intersection_difference(zdd_t f, zdd_t g, zdd_t h);
+zdd_t union_intersection(zdd_t f, zdd_t g, zdd_t h);
 zdd_t join(zdd_t f, zdd_t g);
 zdd_t meet(zdd_t f, zdd_t g);
+zdd_t join(zdd_t f, zdd_t g, int num_threads, int cutoff);
+zdd_t meet(zdd_t f, zdd_t g, int num_threads, int cutoff);
 zdd_t non_subsets(zdd_t f, zdd_t g);
 zdd_t non_supersets(zdd_t f, zdd_t g);
 bool choose(zdd_t f, std::vector<elem_t>* stack);
@@ -78,20 +119,25 @@ zdd_t choose_best(zdd_t f, const std::vector<double>& weights,
                   std::set<elem_t>* s);
 void dump(zdd_t f, std::ostream& out);
 void dump(zdd_t f, FILE* fp = stdout);
+void dump_binary(zdd_t f, std::ostream& out, bool checksum = true);
+void dump_binary(zdd_t f, FILE* fp = stdout, bool checksum = true);
+void dump_binary(zdd_t f, std::string* out, bool checksum = true);
+// Reads the binary format from memory; null() unless it fills the buffer.
+zdd_t load_binary(const char* buf, size_t size);
+// Reads both the text and the binary formats.
 zdd_t load(std::istream& in);
 zdd_t load(FILE* fp = stdin);
+size_t visit(zdd_t f, set_visitor* v, size_t offset = 0,
+             size_t limit = std::numeric_limits<size_t>::max());
 void _enum(zdd_t f, std::ostream& out,
            const std::pair<const char*, const char*>& outer_braces,
            const std::pair<const char*, const char*>& inner_braces);
 void _enum(zdd_t f, FILE* fp,
            const std::pair<const char*, const char*>& outer_braces,
            const std::pair<const char*, const char*>& inner_braces);
-void _enum(zdd_t f, std::ostream& out, std::vector<elem_t>* stack, bool* first,
-           const std::pair<const char*, const char*>& inner_braces);
-void _enum(zdd_t f, FILE* fp, std::vector<elem_t>* stack, bool* first,
-           const std::pair<const char*, const char*>& inner_braces);
 void algo_b(zdd_t f, const std::vector<double>& w, std::vector<bool>* x);
 double algo_c(zdd_t f);
+std::vector<std::string> size_histogram(zdd_t f);
 double probability(elem_t e, zdd_t f, const std::vector<double>& probabilities,
                    std::map<word_t, double>& cache);
 zdd_t zuniq(elem_t v, zdd_t l, zdd_t h);
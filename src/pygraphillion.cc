@@ -29,6 +29,7 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <cstdlib>
 #include <climits>
+#include <limits>
 
 #include <algorithm>
 #include <map>
@@ -493,6 +494,23 @@ static PyObject* setset_len2(PySetsetObject* self, PyObject* args) {
   }
 }
 
+static PyObject* setset_size_histogram(PySetsetObject* self) {
+  vector<string> hist = self->ss->size_histogram();
+  PyObject* l = PyList_New(hist.size());
+  if (l == NULL) return NULL;
+  for (size_t k = 0; k < hist.size(); ++k) {
+    vector<char> buf(hist[k].begin(), hist[k].end());
+    buf.push_back('\0');
+    PyObject* n = PyLong_FromString(buf.data(), NULL, 0);
+    if (n == NULL) {
+      Py_DECREF(l);
+      return NULL;
+    }
+    PyList_SET_ITEM(l, k, n);
+  }
+  return l;
+}
+
 static PyObject* setset_iter(PySetsetObject* self) {
   PySetsetIterObject* ssi = PyObject_New(PySetsetIterObject, &PySetsetIter_Type);
   if (ssi == NULL) return NULL;
@@ -573,6 +591,37 @@ static int setset_contains(PySetsetObject* self, PyObject* obj) {
   }
 }
 
+static PyObject* setset_contains_multi(PySetsetObject* self, PyObject* obj) {
+  PyObject* i = PyObject_GetIter(obj);
+  if (i == NULL) return NULL;
+  vector<set<int> > vs;
+  PyObject* o;
+  while ((o = PyIter_Next(i))) {
+    if (!PyAnySet_Check(o)) {
+      PyErr_SetString(PyExc_TypeError, "not set");
+      Py_DECREF(o);
+      Py_DECREF(i);
+      return NULL;
+    }
+    set<int> s;
+    if (setset_parse_set(o, &s) == -1) {
+      Py_DECREF(o);
+      Py_DECREF(i);
+      return NULL;
+    }
+    vs.push_back(s);
+    Py_DECREF(o);
+  }
+  Py_DECREF(i);
+  if (PyErr_Occurred()) return NULL;
+  vector<bool> found = self->ss->contains(vs);
+  PyObject* l = PyList_New(found.size());
+  if (l == NULL) return NULL;
+  for (size_t j = 0; j < found.size(); ++j)
+    PyList_SET_ITEM(l, j, PyBool_FromLong(found[j]));
+  return l;
+}
+
 static PyObject* setset_add(PySetsetObject* self, PyObject* obj) {
   if (PyAnySet_Check(obj)) {
     set<int> s;
@@ -699,14 +748,95 @@ static PyObject* setset_set_size(PySetsetObject* self, PyObject* io) {
   RETURN_NEW_SETSET(self, self->ss->set_size(set_size));
 }
 
-static PyObject* setset_join(PySetsetObject* self, PyObject* other) {
+static PyObject* setset_weight_range(PySetsetObject* self, PyObject* args) {
+  PyObject* weights = NULL;
+  double lower, upper;
+  if (!PyArg_ParseTuple(args, "Odd", &weights, &lower, &upper)) return NULL;
+  PyObject* i = PyObject_GetIter(weights);
+  if (i == NULL) return NULL;
+  PyObject* eo;
+  vector<double> w;
+  while ((eo = PyIter_Next(i))) {
+    if (PyFloat_Check(eo)) {
+      w.push_back(PyFloat_AsDouble(eo));
+    }
+    else if (PyLong_Check(eo)) {
+      w.push_back(PyLong_AsDouble(eo));
+    }
+    else if (PyInt_Check(eo)) {
+      w.push_back(static_cast<double>(PyInt_AsLong(eo)));
+    }
+    else {
+      PyErr_SetString(PyExc_TypeError, "not a number");
+    }
+    Py_DECREF(eo);
+    if (PyErr_Occurred()) break;
+  }
+  Py_DECREF(i);
+  if (PyErr_Occurred()) return NULL;
+  if (w.size() != static_cast<size_t>(setset::num_elems() + 1)) {
+    PyErr_SetString(PyExc_ValueError, "invalid number of weights");
+    return NULL;
+  }
+  RETURN_NEW_SETSET(self, self->ss->weight_range(w, lower, upper));
+}
+
+static PyObject* setset_intersection_difference(PySetsetObject* self,
+                                                PyObject* args) {
+  PyObject* g = NULL;
+  PyObject* h = NULL;
+  if (!PyArg_ParseTuple(args, "OO", &g, &h)) return NULL;
+  CHECK_SETSET_OR_ERROR(g);
+  CHECK_SETSET_OR_ERROR(h);
+  RETURN_NEW_SETSET(self, self->ss->intersection_difference(
+      *reinterpret_cast<PySetsetObject*>(g)->ss,
+      *reinterpret_cast<PySetsetObject*>(h)->ss));
+}
+
+static PyObject* setset_union_intersection(PySetsetObject* self,
+                                           PyObject* args) {
+  PyObject* g = NULL;
+  PyObject* h = NULL;
+  if (!PyArg_ParseTuple(args, "OO", &g, &h)) return NULL;
+  CHECK_SETSET_OR_ERROR(g);
+  CHECK_SETSET_OR_ERROR(h);
+  RETURN_NEW_SETSET(self, self->ss->union_intersection(
+      *reinterpret_cast<PySetsetObject*>(g)->ss,
+      *reinterpret_cast<PySetsetObject*>(h)->ss));
+}
+
+static PyObject* setset_join(PySetsetObject* self, PyObject* args,
+                             PyObject* kwds) {
+  static char s1[] = "other";
+  static char s2[] = "num_threads";
+  static char s3[] = "cutoff";
+  static char* kwlist[4] = {s1, s2, s3, NULL};
+  PyObject* other = NULL;
+  int num_threads = 1;
+  int cutoff = 8;
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|ii", kwlist, &other,
+                                   &num_threads, &cutoff))
+    return NULL;
   CHECK_SETSET_OR_ERROR(other);
-  RETURN_NEW_SETSET2(self, other, _other, self->ss->join(*_other->ss));
-}
-
-static PyObject* setset_meet(PySetsetObject* self, PyObject* other) {
+  RETURN_NEW_SETSET2(self, other, _other,
+                     self->ss->join(*_other->ss, num_threads, cutoff));
+}
+
+static PyObject* setset_meet(PySetsetObject* self, PyObject* args,
+                             PyObject* kwds) {
+  static char s1[] = "other";
+  static char s2[] = "num_threads";
+  static char s3[] = "cutoff";
+  static char* kwlist[4] = {s1, s2, s3, NULL};
+  PyObject* other = NULL;
+  int num_threads = 1;
+  int cutoff = 8;
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|ii", kwlist, &other,
+                                   &num_threads, &cutoff))
+    return NULL;
   CHECK_SETSET_OR_ERROR(other);
-  RETURN_NEW_SETSET2(self, other, _other, self->ss->meet(*_other->ss));
+  RETURN_NEW_SETSET2(self, other, _other,
+                     self->ss->meet(*_other->ss, num_threads, cutoff));
 }
 
 static PyObject* setset_subsets(PySetsetObject* self, PyObject* other) {
@@ -780,22 +910,56 @@ static PyObject* setset_probability(PySetsetObject* self,
   return PyFloat_FromDouble(self->ss->probability(p));
 }
 
-static PyObject* setset_dump(PySetsetObject* self, PyObject* obj) {
+// Writes the binary format if `binary` is true, or if it is None and the
+// file is opened in binary mode.
+static PyObject* setset_dump(PySetsetObject* self, PyObject* args,
+                             PyObject* kwds) {
+  static char s1[] = "fp";
+  static char s2[] = "binary";
+  static char* kwlist[3] = {s1, s2, NULL};
+  PyObject* obj = NULL;
+  PyObject* binary_obj = Py_None;
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O", kwlist, &obj,
+                                   &binary_obj))
+    return NULL;
   CHECK_OR_ERROR(obj, PyFile_Check, "file", NULL);
   FILE* fp = PyFile_AsFile(obj);
   PyFileObject* file = reinterpret_cast<PyFileObject*>(obj);
+  bool binary;
+  if (binary_obj == Py_None) {
+    binary = PyString_Check(file->f_mode)
+        && strchr(PyString_AsString(file->f_mode), 'b') != NULL;
+  } else {
+    int b = PyObject_IsTrue(binary_obj);
+    if (b < 0) return NULL;
+    binary = b;
+  }
   PyFile_IncUseCount(file);
   Py_BEGIN_ALLOW_THREADS;
-  self->ss->dump(fp);
+  self->ss->dump(fp, binary);
   Py_END_ALLOW_THREADS;
   PyFile_DecUseCount(file);
   Py_RETURN_NONE;
 }
 
-static PyObject* setset_dumps(PySetsetObject* self) {
-  stringstream sstr;
-  self->ss->dump(sstr);
-  return PyString_FromString(sstr.str().c_str());
+static PyObject* setset_dumps(PySetsetObject* self, PyObject* args,
+                              PyObject* kwds) {
+  static char s1[] = "binary";
+  static char* kwlist[2] = {s1, NULL};
+  PyObject* binary_obj = Py_False;
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O", kwlist, &binary_obj))
+    return NULL;
+  int binary = PyObject_IsTrue(binary_obj);
+  if (binary < 0) return NULL;
+  string str;
+  if (binary) {
+    self->ss->dump_binary(&str);
+  } else {
+    stringstream sstr;
+    self->ss->dump(sstr);
+    str = sstr.str();
+  }
+  return PyString_FromStringAndSize(str.data(), str.size());
 }
 
 static PyObject* setset_load(PySetsetObject* self, PyObject* obj) {
@@ -815,10 +979,24 @@ static PyObject* setset_load(PySetsetObject* self, PyObject* obj) {
 
 static PyObject* setset_loads(PySetsetObject* self, PyObject* obj) {
   CHECK_OR_ERROR(obj, PyString_Check, "str", NULL);
-  stringstream sstr(PyString_AsString(obj));
+  const char* buf = PyString_AS_STRING(obj);
+  Py_ssize_t size = PyString_GET_SIZE(obj);
+  setset ss;
+  bool good;
+  if (size > 0 && buf[0] == '\x89') {  // binary, read in place
+    good = setset::load_binary(buf, size, &ss);
+  } else {
+    stringstream sstr(string(buf, size));
+    ss = setset::load(sstr);
+    good = !sstr.bad();
+  }
+  if (!good) {
+    PyErr_SetString(PyExc_ValueError, "invalid or corrupted setset");
+    return NULL;
+  }
   PySetsetObject* ret = reinterpret_cast<PySetsetObject*>(
       PySetset_Type.tp_alloc(&PySetset_Type, 0));
-  ret->ss = new setset(setset::load(sstr));
+  ret->ss = new setset(ss);
   return reinterpret_cast<PyObject*>(ret);
 }
 
@@ -836,6 +1014,29 @@ static PyObject* setset_enum(PySetsetObject* self, PyObject* obj) {
   Py_RETURN_NONE;
 }
 
+static PyObject* setset_write_sets(PySetsetObject* self, PyObject* args) {
+  PyObject* obj = NULL;
+  Py_ssize_t offset = 0;
+  Py_ssize_t limit = -1;
+  if (!PyArg_ParseTuple(args, "O|nn", &obj, &offset, &limit)) return NULL;
+  CHECK_OR_ERROR(obj, PyFile_Check, "file", NULL);
+  if (offset < 0) {
+    PyErr_SetString(PyExc_ValueError, "offset must be non-negative");
+    return NULL;
+  }
+  FILE* fp = PyFile_AsFile(obj);
+  PyFileObject* file = reinterpret_cast<PyFileObject*>(obj);
+  PyFile_IncUseCount(file);
+  size_t n;
+  Py_BEGIN_ALLOW_THREADS;
+  n = self->ss->write_sets(fp, offset,
+                           limit < 0 ? std::numeric_limits<size_t>::max()
+                                     : static_cast<size_t>(limit));
+  Py_END_ALLOW_THREADS;
+  PyFile_DecUseCount(file);
+  return PyInt_FromSize_t(n);
+}
+
 static PyObject* setset_enums(PySetsetObject* self) {
   stringstream sstr;
   string name = self->ob_type->tp_name;
@@ -919,6 +1120,7 @@ static PyMethodDef setset_methods[] = {
   {"rand_iter", reinterpret_cast<PyCFunction>(setset_rand_iter), METH_NOARGS, ""},
   {"max_iter", reinterpret_cast<PyCFunction>(setset_max_iter), METH_O, ""},
   {"min_iter", reinterpret_cast<PyCFunction>(setset_min_iter), METH_O, ""},
+  {"contains", reinterpret_cast<PyCFunction>(setset_contains_multi), METH_O, ""},
   {"add", reinterpret_cast<PyCFunction>(setset_add), METH_O, ""},
   {"remove", reinterpret_cast<PyCFunction>(setset_remove), METH_O, ""},
   {"discard", reinterpret_cast<PyCFunction>(setset_discard), METH_O, ""},
@@ -930,19 +1132,24 @@ static PyMethodDef setset_methods[] = {
   {"smaller", reinterpret_cast<PyCFunction>(setset_smaller), METH_O, ""},
   {"larger", reinterpret_cast<PyCFunction>(setset_larger), METH_O, ""},
   {"set_size", reinterpret_cast<PyCFunction>(setset_set_size), METH_O, ""},
+  {"size_histogram", reinterpret_cast<PyCFunction>(setset_size_histogram), METH_NOARGS, ""},
+  {"weight_range", reinterpret_cast<PyCFunction>(setset_weight_range), METH_VARARGS, ""},
   {"flip", reinterpret_cast<PyCFunction>(setset_flip), METH_VARARGS, ""},
-  {"join", reinterpret_cast<PyCFunction>(setset_join), METH_O, ""},
-  {"meet", reinterpret_cast<PyCFunction>(setset_meet), METH_O, ""},
+  {"intersection_difference", reinterpret_cast<PyCFunction>(setset_intersection_difference), METH_VARARGS, ""},
+  {"union_intersection", reinterpret_cast<PyCFunction>(setset_union_intersection), METH_VARARGS, ""},
+  {"join", reinterpret_cast<PyCFunction>(setset_join), METH_VARARGS | METH_KEYWORDS, ""},
+  {"meet", reinterpret_cast<PyCFunction>(setset_meet), METH_VARARGS | METH_KEYWORDS, ""},
   {"subsets", reinterpret_cast<PyCFunction>(setset_subsets), METH_O, ""},
   {"supersets", reinterpret_cast<PyCFunction>(setset_supersets), METH_O, ""},
   {"non_subsets", reinterpret_cast<PyCFunction>(setset_non_subsets), METH_O, ""},
   {"non_supersets", reinterpret_cast<PyCFunction>(setset_non_supersets), METH_O, ""},
   {"choice", reinterpret_cast<PyCFunction>(setset_choice), METH_NOARGS, ""},
   {"probability", reinterpret_cast<PyCFunction>(setset_probability), METH_O, ""},
-  {"dump", reinterpret_cast<PyCFunction>(setset_dump), METH_O, ""},
-  {"dumps", reinterpret_cast<PyCFunction>(setset_dumps), METH_NOARGS, ""},
+  {"dump", reinterpret_cast<PyCFunction>(setset_dump), METH_VARARGS | METH_KEYWORDS, ""},
+  {"dumps", reinterpret_cast<PyCFunction>(setset_dumps), METH_VARARGS | METH_KEYWORDS, ""},
   {"_enum", reinterpret_cast<PyCFunction>(setset_enum), METH_O, ""},
   {"_enums", reinterpret_cast<PyCFunction>(setset_enums), METH_NOARGS, ""},
+  {"write_sets", reinterpret_cast<PyCFunction>(setset_write_sets), METH_VARARGS, ""},
   {NULL}  /* Sentinel */
 };
 
@@ -1060,6 +1267,39 @@ static PyObject* setset_num_elems(PyObject*, PyObject* args) {
   }
 }
 
+static int graphset_parse_graph(PyObject* graph_obj,
+                                vector<pair<string, string> >* graph) {
+  assert(graph != NULL);
+  if (graph_obj == NULL || graph_obj == Py_None) {
+    PyErr_SetString(PyExc_TypeError, "no graph");
+    return -1;
+  }
+  PyObject* i = PyObject_GetIter(graph_obj);
+  if (i == NULL) return -1;
+  PyObject* eo;
+  while ((eo = PyIter_Next(i))) {
+    PyObject* j = PyObject_GetIter(eo);
+    if (j == NULL) return -1;
+    vector<string> e;
+    PyObject* vo;
+    while ((vo = PyIter_Next(j))) {
+      if (!PyString_Check(vo)) {
+        PyErr_SetString(PyExc_TypeError, "invalid graph");
+        return -1;
+      }
+      string v = PyString_AsString(vo);
+      if (v.find(',') != string::npos) {
+        PyErr_SetString(PyExc_TypeError, "invalid vertex in the graph");
+        return -1;
+      }
+      e.push_back(v);
+    }
+    assert(e.size() == 2);
+    graph->push_back(make_pair(e[0], e[1]));
+  }
+  return 0;
+}
+
 static PyObject* graphset_graphs(PyObject*, PyObject* args, PyObject* kwds) {
   static char s1[] = "graph";
   static char s2[] = "vertex_groups";
@@ -1084,33 +1324,7 @@ static PyObject* graphset_graphs(PyObject*, PyObject* args, PyObject* kwds) {
     return NULL;
 
   vector<pair<string, string> > graph;
-  if (graph_obj == NULL || graph_obj == Py_None) {
-    PyErr_SetString(PyExc_TypeError, "no graph");
-    return NULL;
-  }
-  PyObject* i = PyObject_GetIter(graph_obj);
-  if (i == NULL) return NULL;
-  PyObject* eo;
-  while ((eo = PyIter_Next(i))) {
-    PyObject* j = PyObject_GetIter(eo);
-    if (j == NULL) return NULL;
-    vector<string> e;
-    PyObject* vo;
-    while ((vo = PyIter_Next(j))) {
-      if (!PyString_Check(vo)) {
-        PyErr_SetString(PyExc_TypeError, "invalid graph");
-        return NULL;
-      }
-      string v = PyString_AsString(vo);
-      if (v.find(',') != string::npos) {
-        PyErr_SetString(PyExc_TypeError, "invalid vertex in the graph");
-        return NULL;
-      }
-      e.push_back(v);
-    }
-    assert(e.size() == 2);
-    graph.push_back(make_pair(e[0], e[1]));
-  }
+  if (graphset_parse_graph(graph_obj, &graph) == -1) return NULL;
 
   vector<vector<string> > vertex_groups_entity;
   vector<vector<string> >* vertex_groups = NULL;
@@ -1237,19 +1451,150 @@ static PyObject* graphset_graphs(PyObject*, PyObject* args, PyObject* kwds) {
   return reinterpret_cast<PyObject*>(ret);
 }
 
+static PyObject* graphset_paths(PyObject*, PyObject* args, PyObject* kwds) {
+  static char s1[] = "graph";
+  static char s2[] = "terminal1";
+  static char s3[] = "terminal2";
+  static char s4[] = "is_hamilton";
+  static char s5[] = "search_space";
+  static char* kwlist[6] = {s1, s2, s3, s4, s5, NULL};
+  PyObject* graph_obj = NULL;
+  PyObject* terminal1_obj = NULL;
+  PyObject* terminal2_obj = NULL;
+  int is_hamilton = 0;
+  PyObject* search_space_obj = NULL;
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|OOiO", kwlist, &graph_obj,
+                                   &terminal1_obj, &terminal2_obj,
+                                   &is_hamilton, &search_space_obj))
+    return NULL;
+
+  vector<pair<string, string> > graph;
+  if (graphset_parse_graph(graph_obj, &graph) == -1) return NULL;
+
+  setset* search_space = NULL;
+  if (search_space_obj != NULL && search_space_obj != Py_None)
+    search_space = reinterpret_cast<PySetsetObject*>(search_space_obj)->ss;
+
+  setset ss;
+  if (terminal1_obj == NULL || terminal1_obj == Py_None) {
+    ss = graphillion::SearchCycles(graph, is_hamilton, search_space);
+  } else {
+    if (!PyString_Check(terminal1_obj) || terminal2_obj == NULL
+        || !PyString_Check(terminal2_obj)) {
+      PyErr_SetString(PyExc_TypeError, "invalid vertex");
+      return NULL;
+    }
+    string terminal1 = PyString_AsString(terminal1_obj);
+    string terminal2 = PyString_AsString(terminal2_obj);
+    if (terminal1 == terminal2) {
+      PyErr_SetString(PyExc_ValueError, "same terminals");
+      return NULL;
+    }
+    ss = graphillion::SearchPaths(graph, terminal1, terminal2, is_hamilton,
+                                  search_space);
+  }
+
+  PySetsetObject* ret = reinterpret_cast<PySetsetObject*>
+      (PySetset_Type.tp_alloc(&PySetset_Type, 0));
+  ret->ss = new setset(ss);
+  return reinterpret_cast<PyObject*>(ret);
+}
+
+static PyObject* graphset_frontier_order(PyObject*, PyObject* args) {
+  PyObject* graph_obj = NULL;
+  int beam_width = 16;
+  PyObject* source_obj = NULL;
+  if (!PyArg_ParseTuple(args, "O|iO", &graph_obj, &beam_width, &source_obj))
+    return NULL;
+  if (beam_width < 1) {
+    PyErr_SetString(PyExc_ValueError, "not a positive number");
+    return NULL;
+  }
+  vector<pair<string, string> > graph;
+  if (graphset_parse_graph(graph_obj, &graph) == -1) return NULL;
+  string source;
+  if (source_obj != NULL && source_obj != Py_None) {
+    if (!PyString_Check(source_obj)) {
+      PyErr_SetString(PyExc_TypeError, "invalid vertex");
+      return NULL;
+    }
+    source = PyString_AsString(source_obj);
+  }
+  vector<int> order = graphillion::FrontierOrder(
+      graph, beam_width, source_obj != NULL && source_obj != Py_None ? &source
+                                                                    : NULL);
+  PyObject* l = PyList_New(order.size());
+  for (size_t k = 0; k < order.size(); ++k)
+    PyList_SET_ITEM(l, k, PyInt_FromLong(order[k]));
+  return l;
+}
+
+static PyObject* graphset_max_frontier_size(PyObject*, PyObject* graph_obj) {
+  vector<pair<string, string> > graph;
+  if (graphset_parse_graph(graph_obj, &graph) == -1) return NULL;
+  return PyInt_FromLong(graphillion::MaxFrontierSize(graph));
+}
+
 static PyObject* graphset_show_messages(PySetsetObject* self, PyObject* obj) {
   int ret = graphillion::ShowMessages(PyObject_IsTrue(obj));
   if (ret) Py_RETURN_TRUE;
   else Py_RETURN_FALSE;
 }
 
+static PyObject* graphset_compact_states(PyObject*, PyObject* obj) {
+  if (graphillion::CompactStates(PyObject_IsTrue(obj))) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
+static PyObject* graphset_lookahead(PyObject*, PyObject* args) {
+  int depth = -1;
+  if (!PyArg_ParseTuple(args, "|i", &depth)) return NULL;
+  return PyInt_FromLong(graphillion::Lookahead(depth));
+}
+
+static PyObject* graphset_spill_threshold(PyObject*, PyObject* args) {
+  Py_ssize_t bytes = -1;
+  if (!PyArg_ParseTuple(args, "|n", &bytes)) return NULL;
+  if (bytes < 0) return PyInt_FromSize_t(graphillion::SpillThreshold());
+  return PyInt_FromSize_t(graphillion::SpillThreshold(bytes));
+}
+
+static PyObject* graphset_construction_stats(PyObject*) {
+  graphillion::ConstructionStats s = graphillion::LastConstructionStats();
+  return Py_BuildValue("{s:n,s:i,s:i,s:K,s:i}",
+                       "num_nodes", static_cast<Py_ssize_t>(s.num_nodes),
+                       "state_size", s.state_size,
+                       "num_threads", s.num_threads,
+                       "spilled_size",
+                       static_cast<unsigned long long>(s.spilled_size),
+                       "merge_passes", s.merge_passes);
+}
+
+static PyObject* graphset_num_threads(PyObject*, PyObject* args) {
+  int num_threads = 0;
+  if (!PyArg_ParseTuple(args, "|i", &num_threads)) return NULL;
+  if (num_threads < 0) {
+    PyErr_SetString(PyExc_ValueError, "not a positive number");
+    return NULL;
+  }
+  return PyInt_FromLong(graphillion::NumThreads(num_threads));
+}
+
 static PyMethodDef module_methods[] = {
   {"load", reinterpret_cast<PyCFunction>(setset_load), METH_O, ""},
   {"loads", reinterpret_cast<PyCFunction>(setset_loads), METH_O, ""},
   {"_elem_limit", reinterpret_cast<PyCFunction>(setset_elem_limit), METH_NOARGS, ""},
   {"_num_elems", setset_num_elems, METH_VARARGS, ""},
   {"_graphs", reinterpret_cast<PyCFunction>(graphset_graphs), METH_VARARGS | METH_KEYWORDS, ""},
+  {"_paths", reinterpret_cast<PyCFunction>(graphset_paths), METH_VARARGS | METH_KEYWORDS, ""},
+  {"_frontier_order", graphset_frontier_order, METH_VARARGS, ""},
+  {"_max_frontier_size", graphset_max_frontier_size, METH_O, ""},
   {"_show_messages", reinterpret_cast<PyCFunction>(graphset_show_messages), METH_O, ""},
+  {"_compact_states", graphset_compact_states, METH_O, ""},
+  {"_lookahead", graphset_lookahead, METH_VARARGS, ""},
+  {"_spill_threshold", graphset_spill_threshold, METH_VARARGS, ""},
+  {"_construction_stats", reinterpret_cast<PyCFunction>(graphset_construction_stats), METH_NOARGS, ""},
+  {"_num_threads", graphset_num_threads, METH_VARARGS, ""},
   {NULL}  /* Sentinel */
 };
 
@@ -66,6 +66,18 @@ class DataTable {
 //    DataTable(DataTable const& o);
 //    DataTable& operator=(DataTable const& o);
 
+    /*
+     * Frees all rows.  The destructor must not be called for this purpose
+     * because it is virtual and would also destroy derived members.
+     */
+    void release() {
+        for (int i = 0; i < numRows_; ++i) {
+            delete[] data[i];
+        }
+        delete[] data;
+        delete[] rowSize_;
+    }
+
 public:
     /**
      * Constructor.
@@ -119,7 +131,7 @@ public:
      * @param o the table.
      */
     void moveAssign(DataTable& o) {
-        this->~DataTable();
+        release();
         numRows_ = o.numRows_;
         rowSize_ = o.rowSize_;
         data = o.data;
@@ -144,11 +156,7 @@ public:
      * Destructor.
      */
     virtual ~DataTable() {
-        for (int i = 0; i < numRows_; ++i) {
-            delete[] data[i];
-        }
-        delete[] data;
-        delete[] rowSize_;
+        release();
     }
 
     /**
@@ -156,7 +164,7 @@ public:
      * @param n the number of rows.
      */
     void init(int n) {
-        this->~DataTable();
+        release();
         numRows_ = n;
         rowSize_ = new size_t[n]();
         data = new T*[n]();
@@ -256,6 +264,18 @@ public:
         return k;
     }
 
+    /**
+     * Get the largest number of elements in a row.
+     * @return the largest number of elements in a row.
+     */
+    size_t maxRowSize() const {
+        size_t k = 0;
+        for (int i = 0; i < numRows_; ++i) {
+            if (k < rowSize_[i]) k = rowSize_[i];
+        }
+        return k;
+    }
+
     /**
      * Access to a row.
      * @param i row index.
@@ -7,9 +7,11 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <ostream>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 #ifdef _OPENMP
@@ -93,6 +95,10 @@ public:
               specNodeSize(getSpecNodeSize(spec.datasize())) {
     }
 
+    int numThreads() const {
+        return 1;
+    }
+
     /**
      * Initialization.
      * @param root the root node.
@@ -388,6 +394,10 @@ public:
               specNodeSize(getSpecNodeSize(spec.datasize())), work(input) {
     }
 
+    int numThreads() const {
+        return 1;
+    }
+
     /**
      * Initialization.
      * @param root the root node.
@@ -588,7 +598,8 @@ protected:
     }
 
     static int row(SpecNode const* p) {
-        return ddNodeId(p).row;
+        int i = ddNodeId(p).row;
+        return (i == 65535) ? -1 : i; // -1 is stored as 65535
     }
 
     static size_t col(SpecNode const* p) {
@@ -752,6 +763,7 @@ public:
             for (int const* it = levels.begin(); it != levels.end(); ++it) {
                 work[*it];
             }
+            work[i - 1];
         }
 #endif
 
@@ -773,15 +785,17 @@ public:
                             it != snodes.end(); ++it) {
                         SpecNode* p = *it;
                         *ddSrcPtr(p) = 0;
+                        spec.destruct(state(p));
                     }
                 }
                 else if (f == 1) {
                     for (MyListOnPool<SpecNode>::iterator it = snodes.begin();
                             it != snodes.end(); ++it) {
                         SpecNode* p = *it;
-                        downSpec(p, i, 1, 0);
-                        assert(row(p) == 0 || row(p) == 65535);
+                        downSpec(p, i, b, 0);
+                        assert(row(p) == 0 || row(p) == -1);
                         *ddSrcPtr(p) = (row(p) == 0) ? 0 : 1;
+                        spec.destruct(state(p));
                     }
                 }
             }
@@ -907,7 +921,10 @@ public:
                         DdNodeId dst(ii, ww.outColBase + col(p));
 
                         *ddSrcPtr(p) = dst;
-                        if (col(p) < k) continue;
+                        if (col(p) < k) { // state convergence
+                            spec.destruct(state(p));
+                            continue;
+                        }
                         ++k;
 
                         for (int bb = 0; bb <= 1; ++bb) {
@@ -921,6 +938,9 @@ public:
                             spec.get_copy(state(pp), state(p));
                         }
                     }
+                    else if (row(p) == 0) {
+                        *ddSrcPtr(p) = 0;
+                    }
                     else {
                         assert(row(p) < ii);
                         int iii = inNode.branch[0].row;
@@ -932,6 +952,8 @@ public:
                         ddNodeId(pp) = ddNodeId(p);
                         spec.get_copy(state(pp), state(p));
                     }
+
+                    spec.destruct(state(p));
                 }
 
                 i = w.nextRow[b];
@@ -986,6 +1008,199 @@ private:
             level = spec.get_child(state(p), level, 0);
         }
 
-        ddNodeId(p).row = level; // can be 65535
+        ddNodeId(p).row = level; // -1 is stored as 65535
+    }
+};
+
+/**
+ * Multi-threaded top-down DD builder.
+ * Spec nodes on each level are deduplicated through unique tables sharded
+ * by hash codes, and expanded in fixed-size chunks whose outputs are merged
+ * in chunk order, so that the node numbering does not depend on the number
+ * of threads.
+ */
+template<typename S>
+class DdBuilderMP: DdBuilderBase {
+    typedef S Spec;
+    typedef MyHashTable<SpecNode*,Hasher<Spec>,Hasher<Spec> > UniqTable;
+    typedef std::vector<std::pair<int,SpecNode*> > Buffer;
+
+    static size_t const chunkSize = 256;
+
+    DdNodeTable& output;
+    Spec& spec;
+    Hasher<Spec> const hasher;
+    int const specNodeSize;
+
+    int const maxThreads;
+    std::vector<std::vector<MemoryPool> > pools;
+    std::vector<std::vector<SpecNode*> > snodeTable;
+
+public:
+    DdBuilderMP(Spec& s, DdNodeTable& output)
+            : output(output), spec(s), hasher(spec),
+              specNodeSize(getSpecNodeSize(spec.datasize())),
+#ifdef _OPENMP
+              maxThreads(omp_get_max_threads()),
+#else
+              maxThreads(1),
+#endif
+              pools(maxThreads) {
+    }
+
+    int numThreads() const {
+        return maxThreads;
+    }
+
+    /**
+     * Initialization.
+     * @param root the root node.
+     */
+    void initialize(DdNodeId& root) {
+        std::vector<SpecNode> tmp(specNodeSize);
+        SpecNode* ptmp = tmp.data();
+        int n = spec.get_root(state(ptmp));
+
+        if (n <= 0) {
+            root = DdNodeId(-n);
+            n = 0;
+        }
+        else {
+            root = DdNodeId(n, 0);
+            for (int t = 0; t < maxThreads; ++t) {
+                pools[t].resize(n + 1);
+            }
+            snodeTable.resize(n + 1);
+            SpecNode* p0 = pools[0][n].allocate<SpecNode>(specNodeSize);
+            spec.get_copy(state(p0), state(ptmp));
+            source(p0) = &root;
+            snodeTable[n].push_back(p0);
+        }
+
+        spec.destruct(state(ptmp));
+        output.init(n + 1);
+    }
+
+    /**
+     * Build one level.
+     * @param i level.
+     */
+    void construct(int i) {
+        assert(0 < i && i < output.numRows());
+        assert(output.numRows() - snodeTable.size() == 0);
+
+        std::vector<SpecNode*>& vnodes = snodeTable[i];
+        size_t const n = vnodes.size();
+        size_t const numShards = maxThreads * 8;
+        std::vector<SpecNode*> reps(n);
+
+        { // find the first node of each state
+            std::vector<size_t> hashes(n);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+            for (size_t k = 0; k < n; ++k) {
+                hashes[k] = hasher(vnodes[k]) % numShards;
+            }
+
+            std::vector<std::vector<size_t> > shards(numShards);
+            for (size_t k = 0; k < n; ++k) {
+                shards[hashes[k]].push_back(k);
+            }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+            for (size_t h = 0; h < numShards; ++h) {
+                std::vector<size_t> const& ks = shards[h];
+                UniqTable uniq(ks.size() * 2, hasher, hasher);
+
+                for (size_t k = 0; k < ks.size(); ++k) {
+                    reps[ks[k]] = uniq.add(vnodes[ks[k]]);
+                }
+            }
+        }
+
+        size_t m = 0;
+
+        for (size_t k = 0; k < n; ++k) {
+            SpecNode* p = vnodes[k];
+
+            if (reps[k] == p) {
+                nodeId(p) = *source(p) = DdNodeId(i, m);
+                vnodes[m++] = p;
+            }
+            else {
+                *source(p) = nodeId(reps[k]);
+                spec.destruct(state(p));
+            }
+        }
+
+        DdNode* const q = output.initRow(i, m);
+        size_t const numChunks = (m + chunkSize - 1) / chunkSize;
+        std::vector<Buffer> buffers(numChunks);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+#ifdef _OPENMP
+            int const t = omp_get_thread_num();
+#else
+            int const t = 0;
+#endif
+            SpecNode* pp = pools[t][i - 1].allocate<SpecNode>(specNodeSize);
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+            for (size_t c = 0; c < numChunks; ++c) {
+                Buffer& buffer = buffers[c];
+                size_t const end = std::min((c + 1) * chunkSize, m);
+
+                for (size_t j = c * chunkSize; j < end; ++j) {
+                    SpecNode* p = vnodes[j];
+
+                    for (int b = 0; b <= 1; ++b) {
+                        spec.get_copy(state(pp), state(p));
+                        int ii = spec.get_child(state(pp), i, b);
+
+                        if (ii <= 0) {
+                            spec.destruct(state(pp));
+                            q[j].branch[b] = DdNodeId(-ii);
+                        }
+                        else if (ii == i - 1) {
+                            source(pp) = &q[j].branch[b];
+                            buffer.push_back(std::make_pair(ii, pp));
+                            pp = pools[t][ii].allocate<SpecNode>(specNodeSize);
+                        }
+                        else {
+                            assert(ii < i - 1);
+                            SpecNode* ppp = pools[t][ii].allocate<SpecNode>(
+                                    specNodeSize);
+                            spec.get_copy(state(ppp), state(pp));
+                            spec.destruct(state(pp));
+                            source(ppp) = &q[j].branch[b];
+                            buffer.push_back(std::make_pair(ii, ppp));
+                        }
+                    }
+
+                    spec.destruct(state(p));
+                }
+            }
+        }
+
+        for (size_t c = 0; c < numChunks; ++c) {
+            for (Buffer::const_iterator it = buffers[c].begin();
+                    it != buffers[c].end(); ++it) {
+                snodeTable[it->first].push_back(it->second);
+            }
+        }
+
+        std::vector<SpecNode*>().swap(vnodes);
+        for (int t = 0; t < maxThreads; ++t) {
+            pools[t][i].clear();
+        }
+        spec.destructLevel(i);
     }
 };
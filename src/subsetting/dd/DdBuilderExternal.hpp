@@ -0,0 +1,562 @@
+/*********************************************************************
+Copyright 2013  JST ERATO Minato project and other contributors
+http://www-erato.ist.hokudai.ac.jp/?language=en
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**********************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "DdBuilder.hpp"
+#include "DdNode.hpp"
+#include "DdNodeTable.hpp"
+#include "../util/MyHashTable.hpp"
+#include "../util/MyList.hpp"
+#include "../util/MyVector.hpp"
+#include "../util/SpillFile.hpp"
+
+/**
+ * Top-down DD builder in external memory.
+ * Pending spec nodes are kept in memory up to a given size.  Beyond it,
+ * they are sorted by hash code and written to a temporary file as runs,
+ * which are merged to find equivalent states when their level is built.
+ * Levels that have never been spilled are built in the same way as
+ * DdBuilder.
+ * When the limit is exceeded, the largest lists are spilled first until
+ * half of it is used, so that runs do not get too small; the level being
+ * built does not count.  Too many runs of a level are merged in several
+ * passes, so that the readers also fit in the limit.
+ * Spec nodes are moved by byte copy, so that states must not point into
+ * themselves.
+ */
+template<typename S>
+class DdBuilderExternal: DdBuilderBase {
+    typedef S Spec;
+    typedef MyList<SpecNode> List;
+    typedef MyHashTable<SpecNode*,Hasher<Spec>,Hasher<Spec> > UniqTable;
+    typedef std::vector<SpecNode> Buffer;
+    typedef std::pair<size_t,size_t> HashIndex;
+    typedef std::priority_queue<HashIndex,std::vector<HashIndex>,
+            std::greater<HashIndex> > Queue;
+    static size_t const CHUNK_BYTES = 1 << 16;
+    static size_t const READ_BYTES = 1 << 12; ///< buffer size of a reader.
+    static size_t const MIN_MEMORY = 2 * CHUNK_BYTES;
+    static size_t const MAX_FAN_IN = 256;
+
+    /**
+     * Sequence of spec nodes in the file.
+     */
+    struct Run {
+        uint64_t offset;
+        size_t size; ///< the number of spec nodes.
+
+        Run(uint64_t offset, size_t size)
+                : offset(offset), size(size) {
+        }
+    };
+
+    /**
+     * Sequential reader of a run.
+     */
+    struct Reader {
+        Run run;
+        Buffer chunk;
+        size_t pos;
+        size_t end;
+
+        Reader(Run const& run)
+                : run(run), pos(0), end(0) {
+        }
+    };
+
+    DdNodeTable& output;
+    Spec& spec;
+    Hasher<Spec> const hasher;
+    int const specNodeSize;
+    size_t const specNodeBytes; ///< memory for a spec node in a list.
+    size_t const chunkSize;     ///< the number of spec nodes in a chunk.
+    size_t const readSize;      ///< the number of spec nodes in a read.
+    size_t const memoryLimit;
+    size_t const fanIn; ///< the max number of runs merged at a time.
+    size_t memoryUsage;
+    int maxPasses; ///< the max number of merge passes over a level.
+
+    SpillFile file;
+    MyVector<List> snodeTable; ///< pending spec nodes in memory.
+    std::vector<std::vector<Run> > runs; ///< pending spec nodes in the file.
+
+    int current; ///< the level being built, or 0.
+    bool merging;
+    Buffer group;
+    std::vector<SpecNode*> members;
+    std::vector<SpecNode*> reps;
+    List uniques;
+    std::vector<Run> uniqueRuns;
+    size_t numUniques;
+    Buffer tmp;
+
+    SpecNode* alloc(List& list) {
+        memoryUsage += specNodeBytes;
+        return list.alloc_front(specNodeSize);
+    }
+
+    size_t bytes(List const& list) const {
+        return list.size() * specNodeBytes;
+    }
+
+    void release(List& list) {
+        memoryUsage -= bytes(list);
+        list.clear();
+    }
+
+    void copy(SpecNode* to, SpecNode const* from) const {
+        std::copy(from, from + specNodeSize, to);
+    }
+
+    /**
+     * Writes spec nodes to the file.
+     * @param nodes the spec nodes.
+     * @return the run.
+     */
+    Run write(std::vector<SpecNode*> const& nodes) {
+        Buffer chunk(chunkSize * specNodeSize);
+        uint64_t offset = file.size();
+        size_t k = 0;
+
+        while (k < nodes.size()) {
+            size_t n = std::min(nodes.size() - k, chunkSize);
+            for (size_t j = 0; j < n; ++j) {
+                copy(&chunk[j * specNodeSize], nodes[k++]);
+            }
+            file.append(&chunk[0], n * specNodeSize * sizeof(SpecNode));
+        }
+
+        return Run(offset, nodes.size());
+    }
+
+    /**
+     * Lists spec nodes in the order of hash code.
+     * @param list the spec nodes.
+     * @param nodes the spec nodes in the order.
+     */
+    void sortByHash(List& list, std::vector<SpecNode*>& nodes) const {
+        std::vector<HashIndex> order;
+        std::vector<SpecNode*> tmpNodes;
+        order.reserve(list.size());
+        tmpNodes.reserve(list.size());
+
+        for (List::iterator t = list.begin(); t != list.end(); ++t) {
+            order.push_back(HashIndex(spec.hash_code(state(*t)),
+                    tmpNodes.size()));
+            tmpNodes.push_back(*t);
+        }
+        std::sort(order.begin(), order.end());
+
+        nodes.resize(order.size());
+        for (size_t k = 0; k < order.size(); ++k) {
+            nodes[k] = tmpNodes[order[k].second];
+        }
+    }
+
+    /**
+     * Moves pending spec nodes of a level to the file.
+     * @param i level.
+     */
+    void spill(int i) {
+        List& list = snodeTable[i];
+        if (list.empty()) return;
+
+        std::vector<SpecNode*> nodes;
+        sortByHash(list, nodes);
+        runs[i].push_back(write(nodes));
+        release(list);
+    }
+
+    /**
+     * Moves unique spec nodes of the current level to the file.
+     */
+    void spillUniques() {
+        if (uniques.empty()) return;
+
+        std::vector<SpecNode*> nodes;
+        nodes.reserve(uniques.size());
+        for (List::iterator t = uniques.begin(); t != uniques.end(); ++t) {
+            nodes.push_back(*t);
+        }
+        uniqueRuns.push_back(write(nodes));
+        release(uniques);
+    }
+
+    void checkMemory() {
+        size_t usage = memoryUsage;
+        if (current > 0) usage -= bytes(snodeTable[current]);
+        if (usage <= memoryLimit) return;
+
+        std::vector<std::pair<size_t,int> > lists; // (bytes, level)
+        for (size_t i = 0; i < snodeTable.size(); ++i) {
+            if (int(i) == current || snodeTable[i].empty()) continue;
+            lists.push_back(std::make_pair(bytes(snodeTable[i]), int(i)));
+        }
+        if (merging && !uniques.empty()) {
+            lists.push_back(std::make_pair(bytes(uniques), -1));
+        }
+        std::sort(lists.begin(), lists.end(),
+                std::greater<std::pair<size_t,int> >());
+
+        for (size_t k = 0; k < lists.size() && usage > memoryLimit / 2;
+                ++k) {
+            if (lists[k].second < 0) spillUniques();
+            else spill(lists[k].second);
+            usage -= lists[k].first;
+        }
+    }
+
+    bool fill(Reader& r) {
+        if (r.pos < r.end) return true;
+        if (r.run.size == 0) return false;
+
+        size_t n = std::min(r.run.size, readSize);
+        size_t bytes = n * specNodeSize * sizeof(SpecNode);
+        r.chunk.resize(n * specNodeSize);
+        file.read(r.run.offset, &r.chunk[0], bytes);
+        r.run.offset += bytes;
+        r.run.size -= n;
+        r.pos = 0;
+        r.end = n;
+        return true;
+    }
+
+    /**
+     * Finds unique states among spec nodes of the same hash code.
+     * Each unique state gets a node ID, which replaces its source.
+     * @param i level.
+     */
+    void flushGroup(int i) {
+        reps.clear();
+
+        for (size_t k = 0; k < members.size(); ++k) {
+            SpecNode* p = members[k];
+            size_t r = 0;
+            while (r < reps.size()
+                    && !spec.equal_to(state(reps[r]), state(p))) {
+                ++r;
+            }
+
+            if (r < reps.size()) {
+                *source(p) = nodeId(reps[r]);
+                spec.destruct(state(p));
+            }
+            else {
+                DdNodeId f(i, numUniques++);
+                *source(p) = f;
+                nodeId(p) = f;
+                reps.push_back(p);
+            }
+        }
+
+        for (size_t r = 0; r < reps.size(); ++r) {
+            copy(alloc(uniques), reps[r]);
+        }
+        members.clear();
+        checkMemory();
+    }
+
+    void startReaders(std::vector<Reader>& readers, Queue& queue) {
+        for (size_t r = 0; r < readers.size(); ++r) {
+            if (fill(readers[r])) {
+                SpecNode* p = &readers[r].chunk[0];
+                queue.push(HashIndex(spec.hash_code(state(p)), r));
+            }
+        }
+    }
+
+    /**
+     * Takes the spec node of the least hash code from the readers.
+     * @param readers the readers.
+     * @param queue the hash codes of their heads.
+     * @param to the spec node to be overwritten.
+     * @return the hash code.
+     */
+    size_t next(std::vector<Reader>& readers, Queue& queue, SpecNode* to) {
+        HashIndex hi = queue.top();
+        queue.pop();
+        Reader& rd = readers[hi.second];
+        copy(to, &rd.chunk[rd.pos++ * specNodeSize]);
+
+        if (fill(rd)) {
+            SpecNode* p = &rd.chunk[rd.pos * specNodeSize];
+            queue.push(HashIndex(spec.hash_code(state(p)), hi.second));
+        }
+        else {
+            Buffer().swap(rd.chunk);
+        }
+        return hi.first;
+    }
+
+    /**
+     * Merges runs into one in the order of hash code.
+     * @param in the runs.
+     * @return the merged run.
+     */
+    Run mergeRuns(std::vector<Run> const& in) {
+        std::vector<Reader> readers(in.begin(), in.end());
+        Queue queue;
+        startReaders(readers, queue);
+
+        Buffer chunk(chunkSize * specNodeSize);
+        Run out(file.size(), 0);
+        size_t k = 0;
+
+        while (!queue.empty()) {
+            next(readers, queue, &chunk[k++ * specNodeSize]);
+            if (k == chunkSize || queue.empty()) {
+                file.append(&chunk[0], k * specNodeSize * sizeof(SpecNode));
+                out.size += k;
+                k = 0;
+            }
+        }
+        return out;
+    }
+
+    /**
+     * Merges the runs of a level until they can be read at a time.
+     * @param i level.
+     */
+    void reduceRuns(int i) {
+        int passes = 1;
+        for (; runs[i].size() > fanIn; ++passes) {
+            std::vector<Run> merged;
+            for (size_t k = 0; k < runs[i].size(); k += fanIn) {
+                size_t e = std::min(k + fanIn, runs[i].size());
+                if (e - k == 1) {
+                    merged.push_back(runs[i][k]);
+                }
+                else {
+                    merged.push_back(mergeRuns(std::vector<Run>(
+                            runs[i].begin() + k, runs[i].begin() + e)));
+                }
+            }
+            runs[i].swap(merged);
+        }
+        maxPasses = std::max(maxPasses, passes);
+    }
+
+    void merge(int i) {
+        std::vector<Reader> readers(runs[i].begin(), runs[i].end());
+        std::vector<Run>().swap(runs[i]);
+        Queue queue;
+        startReaders(readers, queue);
+
+        group.resize(specNodeSize);
+        while (!queue.empty()) {
+            size_t h = next(readers, queue,
+                    &group[group.size() - specNodeSize]);
+
+            if (queue.empty() || queue.top().first != h) {
+                size_t const n = group.size() / specNodeSize;
+                for (size_t k = 0; k < n; ++k) {
+                    members.push_back(&group[k * specNodeSize]);
+                }
+                flushGroup(i);
+                group.resize(specNodeSize);
+            }
+            else {
+                group.resize(group.size() + specNodeSize);
+            }
+        }
+        Buffer().swap(group);
+    }
+
+    /**
+     * Makes child nodes of a unique spec node.
+     * @param i level.
+     * @param p the spec node to be destructed.
+     */
+    void expand(int i, SpecNode* p) {
+        DdNode& q = output[i][nodeId(p).col];
+        SpecNode* pp = &tmp[0];
+
+        for (int b = 0; b <= 1; ++b) {
+            spec.get_copy(state(pp), state(p));
+            int ii = spec.get_child(state(pp), i, b);
+
+            if (ii <= 0) {
+                spec.destruct(state(pp));
+                q.branch[b] = DdNodeId(-ii);
+            }
+            else {
+                assert(ii < i);
+                source(pp) = &q.branch[b];
+                copy(alloc(snodeTable[ii]), pp);
+                checkMemory();
+            }
+        }
+
+        spec.destruct(state(p));
+    }
+
+public:
+    /**
+     * Constructor.
+     * @param s the spec.
+     * @param output the output table.
+     * @param memoryLimit the size of memory for pending spec nodes, which
+     *        is raised to minMemory if smaller.
+     * @param minMemory the lower limit of memoryLimit, or 0 for
+     *        MIN_MEMORY; a smaller one also merges fewer runs at a time.
+     */
+    DdBuilderExternal(Spec& s, DdNodeTable& output, size_t memoryLimit,
+            size_t minMemory = 0)
+            : output(output), spec(s), hasher(spec),
+              specNodeSize(getSpecNodeSize(spec.datasize())),
+              specNodeBytes((specNodeSize + 1) * sizeof(SpecNode)),
+              chunkSize(std::max(CHUNK_BYTES / (specNodeSize
+                      * sizeof(SpecNode)), size_t(1))),
+              readSize(std::max(READ_BYTES / (specNodeSize
+                      * sizeof(SpecNode)), size_t(1))),
+              memoryLimit(std::max(memoryLimit,
+                      minMemory > 0 ? minMemory : size_t(MIN_MEMORY))),
+              fanIn(std::min(std::max(this->memoryLimit / READ_BYTES,
+                      size_t(2)), size_t(MAX_FAN_IN))),
+              memoryUsage(0), maxPasses(0), current(0),
+              merging(false), numUniques(0), tmp(specNodeSize) {
+    }
+
+    int numThreads() const {
+        return 1;
+    }
+
+    /**
+     * Gets the number of bytes written to the temporary file.
+     * @return the number of bytes.
+     */
+    uint64_t spilledSize() const {
+        return file.size();
+    }
+
+    /**
+     * Gets the max number of passes in which runs of a level were merged.
+     * @return the number of passes, or 0 if no level was spilled.
+     */
+    int mergePasses() const {
+        return maxPasses;
+    }
+
+    /**
+     * Initialization.
+     * @param root the root node.
+     */
+    void initialize(DdNodeId& root) {
+        SpecNode* ptmp = &tmp[0];
+        int n = spec.get_root(state(ptmp));
+
+        if (n <= 0) {
+            root = DdNodeId(-n);
+            spec.destruct(state(ptmp));
+            n = 0;
+        }
+        else {
+            root = DdNodeId(n, 0);
+            snodeTable.resize(n + 1);
+            runs.resize(n + 1);
+            source(ptmp) = &root;
+            copy(alloc(snodeTable[n]), ptmp);
+        }
+
+        output.init(n + 1);
+    }
+
+    /**
+     * Build one level.
+     * @param i level.
+     */
+    void construct(int i) {
+        assert(0 < i && i < output.numRows());
+
+        numUniques = 0;
+        current = i;
+
+        if (runs[i].empty()) {
+            List& vnodes = snodeTable[i];
+
+            {
+                UniqTable uniq(vnodes.size() * 2, hasher, hasher);
+
+                for (List::iterator t = vnodes.begin(); t != vnodes.end();
+                        ++t) {
+                    SpecNode* p = *t;
+                    SpecNode* pp = uniq.add(p);
+
+                    if (pp == p) {
+                        nodeId(p) = *source(p) = DdNodeId(i, numUniques++);
+                    }
+                    else {
+                        *source(p) = nodeId(pp);
+                        nodeId(p) = 0;
+                    }
+                }
+            }
+
+            output.initRow(i, numUniques);
+
+            for (List::iterator t = vnodes.begin(); t != vnodes.end(); ++t) {
+                if (nodeId(*t) == 0) {
+                    spec.destruct(state(*t));
+                }
+                else {
+                    expand(i, *t);
+                }
+            }
+            release(vnodes);
+        }
+        else {
+            spill(i);
+            reduceRuns(i);
+            merging = true;
+            merge(i);
+            merging = false;
+            output.initRow(i, numUniques);
+
+            for (size_t r = 0; r < uniqueRuns.size(); ++r) {
+                Reader rd(uniqueRuns[r]);
+                while (fill(rd)) {
+                    expand(i, &rd.chunk[rd.pos++ * specNodeSize]);
+                }
+            }
+            std::vector<Run>().swap(uniqueRuns);
+
+            for (List::iterator t = uniques.begin(); t != uniques.end();
+                    ++t) {
+                expand(i, *t);
+            }
+            release(uniques);
+        }
+
+        current = 0;
+        spec.destructLevel(i);
+    }
+};
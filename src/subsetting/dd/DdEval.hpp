@@ -43,6 +43,15 @@ struct DdEval {
     void initialize(int level) {
     }
 
+    /**
+     * Initialization of a level.
+     * It is called before the nodes at the level are evaluated.
+     * @param level the level.
+     * @param size the number of nodes at the level.
+     */
+    void initializeLevel(int level, size_t size) {
+    }
+
     /**
      * Makes a result value.
      */
@@ -10,6 +10,8 @@
 #include <cassert>
 #include <functional>
 #include <iostream>
+#include <stdint.h>
+#include <vector>
 
 #include "DdNodeId.hpp"
 
@@ -31,6 +33,13 @@
  */
 template<typename S>
 struct DdSpec {
+    /**
+     * Whether different states can be handled by multiple threads at once.
+     * Specs sharing work space or calling non-reentrant libraries must hide
+     * this with false.
+     */
+    static bool const isThreadSafe = true;
+
     S& entity() {
         return *static_cast<S*>(this);
     }
@@ -508,6 +517,436 @@ public:
     }
 };
 
+/**
+ * Bit-level access to states packed into 64-bit words.
+ */
+struct PackedBits {
+    typedef uint64_t Word;
+
+    /**
+     * Returns the number of bits to represent integers up to @p maxValue.
+     */
+    static int bitsFor(uint64_t maxValue) {
+        int bits = 1;
+        while (bits < 64 && (maxValue >> bits) != 0) {
+            ++bits;
+        }
+        return bits;
+    }
+
+    static int wordsFor(size_t bits) {
+        return (bits + 63) / 64;
+    }
+
+    /**
+     * Reads consecutive integers of @p bits bits from @p a.
+     */
+    class Reader {
+        Word const* q;
+        int const bits;
+        uint64_t const mask;
+        int k; ///< bits consumed in *q.
+
+    public:
+        Reader(Word const* a, int bits)
+                : q(a), bits(bits),
+                  mask(bits < 64 ? (uint64_t(1) << bits) - 1 : ~uint64_t(0)),
+                  k(0) {
+        }
+
+        uint64_t get() {
+            uint64_t x = *q >> k;
+            k += bits;
+            if (k >= 64) {
+                k -= 64;
+                ++q;
+                if (k > 0) x |= *q << (bits - k);
+            }
+            return x & mask;
+        }
+    };
+
+    /**
+     * Writes consecutive integers of @p bits bits to @p a, filling the
+     * last word with zeros on flush().
+     */
+    class Writer {
+        Word* q;
+        int const bits;
+        Word w;
+        int k; ///< bits filled in w.
+
+    public:
+        Writer(Word* a, int bits)
+                : q(a), bits(bits), w(0), k(0) {
+        }
+
+        void put(uint64_t x) {
+            w |= x << k;
+            k += bits;
+            if (k >= 64) {
+                *q++ = w;
+                k -= 64;
+                w = (k > 0) ? x >> (bits - k) : 0;
+            }
+        }
+
+        void flush() {
+            if (k > 0) *q++ = w;
+        }
+    };
+};
+
+/**
+ * Abstract class of DD specifications using array states that can be
+ * stored with each element packed into a fixed number of bits.  Packed
+ * states are unpacked to a work array of @p T, which is passed to the
+ * implementation, and packed again only if the result is a nonterminal.
+ * Otherwise states are plain arrays of @p T as in PodArrayDdSpec.
+ * Hashing and comparison work on the stored words in either case.
+ * Every implementation must have the following functions:
+ * - int getRoot(T* array)
+ * - int getChild(T* array, int level, bool take)
+ * - uint64_t packElement(T const& a) const
+ * - T unpackElement(uint64_t x) const
+ * @param S the class implementing this class.
+ * @param T data type of array elements.
+ */
+template<typename S, typename T>
+class PackedArrayDdSpec: public DdSpec<S> {
+public:
+    typedef T State;
+
+private:
+    typedef PackedBits::Word Word;
+    static int const LOCAL_WORDS = 32; ///< work array on the stack.
+
+    int arraySize;
+    int elementBits; ///< zero if not packed.
+    int dataWords;
+
+    static State* state(void* p) {
+        return static_cast<State*>(p);
+    }
+
+    static State const* state(void const* p) {
+        return static_cast<State const*>(p);
+    }
+
+    State* workArray(Word* local, std::vector<Word>& heap) const {
+        size_t n = (arraySize * sizeof(State) + sizeof(Word) - 1)
+                / sizeof(Word);
+        if (n <= size_t(LOCAL_WORDS)) return reinterpret_cast<State*>(local);
+        heap.resize(n);
+        return reinterpret_cast<State*>(&heap[0]);
+    }
+
+    void pack(State const* a, void* p) const {
+        PackedBits::Writer w(static_cast<Word*>(p), elementBits);
+        for (int i = 0; i < arraySize; ++i) {
+            w.put(this->entity().packElement(a[i]));
+        }
+        w.flush();
+    }
+
+    void unpack(void const* p, State* a) const {
+        PackedBits::Reader r(static_cast<Word const*>(p), elementBits);
+        for (int i = 0; i < arraySize; ++i) {
+            a[i] = this->entity().unpackElement(r.get());
+        }
+    }
+
+protected:
+    /**
+     * Sets the array size and the layout of states.
+     * @param n the number of array elements.
+     * @param bits the number of bits for an element, or zero to store
+     *        states as plain arrays.
+     */
+    void setArraySize(int n, int bits) {
+        assert(0 <= n);
+        assert(0 <= bits && bits <= 64);
+        arraySize = n;
+        elementBits = bits;
+        dataWords = (bits > 0) ? PackedBits::wordsFor(size_t(n) * bits)
+                : (n * sizeof(State) + sizeof(Word) - 1) / sizeof(Word);
+    }
+
+public:
+    PackedArrayDdSpec()
+            : arraySize(-1), elementBits(-1), dataWords(-1) {
+    }
+
+    int datasize() const {
+        return dataWords * sizeof(Word);
+    }
+
+    int get_root(void* p) {
+        Word* q = static_cast<Word*>(p);
+        for (int k = 0; k < dataWords; ++k) {
+            q[k] = 0;
+        }
+        if (elementBits == 0) return this->entity().getRoot(state(p));
+
+        Word local[LOCAL_WORDS] = {};
+        std::vector<Word> heap;
+        State* a = workArray(local, heap);
+        int i = this->entity().getRoot(a);
+        if (i > 0) pack(a, p);
+        return i;
+    }
+
+    int get_child(void* p, int level, bool take) {
+        if (elementBits == 0) {
+            return this->entity().getChild(state(p), level, take);
+        }
+
+        Word local[LOCAL_WORDS];
+        std::vector<Word> heap;
+        State* a = workArray(local, heap);
+        unpack(p, a);
+        int i = this->entity().getChild(a, level, take);
+        if (i > 0) pack(a, p);
+        return i;
+    }
+
+    void get_copy(void* to, void const* from) {
+        Word const* pa = static_cast<Word const*>(from);
+        Word const* pz = pa + dataWords;
+        Word* qa = static_cast<Word*>(to);
+        while (pa != pz) {
+            *qa++ = *pa++;
+        }
+    }
+
+    void destruct(void* p) {
+    }
+
+    void destructLevel(int level) {
+    }
+
+    size_t hash_code(void const* p) const {
+        Word const* pa = static_cast<Word const*>(p);
+        Word const* pz = pa + dataWords;
+        size_t h = 0;
+        while (pa != pz) {
+            h += *pa++;
+            h *= 314159257;
+        }
+        return h;
+    }
+
+    bool equal_to(void const* p, void const* q) const {
+        Word const* pa = static_cast<Word const*>(p);
+        Word const* qa = static_cast<Word const*>(q);
+        Word const* pz = pa + dataWords;
+        while (pa != pz) {
+            if (*pa++ != *qa++) return false;
+        }
+        return true;
+    }
+
+    std::ostream& print(std::ostream& os, void const* p) const {
+        Word local[LOCAL_WORDS];
+        std::vector<Word> heap;
+        State const* a = state(p);
+        if (elementBits > 0) {
+            State* b = workArray(local, heap);
+            unpack(p, b);
+            a = b;
+        }
+        os << "[";
+        for (int i = 0; i < arraySize; ++i) {
+            if (i > 0) os << ",";
+            os << a[i];
+        }
+        return os << "]";
+    }
+};
+
+/**
+ * Abstract class of DD specifications using a POD scalar and an array
+ * that can be packed as in PackedArrayDdSpec.  The scalar is stored as is.
+ * Every implementation must have the following functions:
+ * - int getRoot(TS& scalar, TA* array)
+ * - int getChild(TS& scalar, TA* array, int level, bool take)
+ * - uint64_t packElement(TA const& a) const
+ * - TA unpackElement(uint64_t x) const
+ * @param S the class implementing this class.
+ * @param TS data type of scalar.
+ * @param TA data type of array elements.
+ */
+template<typename S, typename TS, typename TA>
+class PackedHybridDdSpec: public DdSpec<S> {
+public:
+    typedef TS S_State;
+    typedef TA A_State;
+
+private:
+    typedef PackedBits::Word Word;
+    static int const LOCAL_WORDS = 32; ///< work array on the stack.
+    static int const SCALAR_WORDS = (sizeof(S_State) + sizeof(Word) - 1)
+            / sizeof(Word);
+
+    int arraySize;
+    int elementBits; ///< zero if not packed.
+    int dataWords;
+
+    static S_State& s_state(void* p) {
+        return *static_cast<S_State*>(p);
+    }
+
+    static S_State const& s_state(void const* p) {
+        return *static_cast<S_State const*>(p);
+    }
+
+    static A_State* a_state(void* p) {
+        return reinterpret_cast<A_State*>(static_cast<Word*>(p)
+                + SCALAR_WORDS);
+    }
+
+    static A_State const* a_state(void const* p) {
+        return reinterpret_cast<A_State const*>(static_cast<Word const*>(p)
+                + SCALAR_WORDS);
+    }
+
+    A_State* workArray(Word* local, std::vector<Word>& heap) const {
+        size_t n = (arraySize * sizeof(A_State) + sizeof(Word) - 1)
+                / sizeof(Word);
+        if (n <= size_t(LOCAL_WORDS)) return reinterpret_cast<A_State*>(local);
+        heap.resize(n);
+        return reinterpret_cast<A_State*>(&heap[0]);
+    }
+
+    void pack(A_State const* a, void* p) const {
+        PackedBits::Writer w(static_cast<Word*>(p) + SCALAR_WORDS,
+                elementBits);
+        for (int i = 0; i < arraySize; ++i) {
+            w.put(this->entity().packElement(a[i]));
+        }
+        w.flush();
+    }
+
+    void unpack(void const* p, A_State* a) const {
+        PackedBits::Reader r(static_cast<Word const*>(p) + SCALAR_WORDS,
+                elementBits);
+        for (int i = 0; i < arraySize; ++i) {
+            a[i] = this->entity().unpackElement(r.get());
+        }
+    }
+
+protected:
+    /**
+     * Sets the array size and the layout of states.
+     * @param n the number of array elements.
+     * @param bits the number of bits for an element, or zero to store
+     *        arrays as they are.
+     */
+    void setArraySize(int n, int bits) {
+        assert(0 <= n);
+        assert(0 <= bits && bits <= 64);
+        arraySize = n;
+        elementBits = bits;
+        dataWords = SCALAR_WORDS + ((bits > 0)
+                ? PackedBits::wordsFor(size_t(n) * bits)
+                : (n * sizeof(A_State) + sizeof(Word) - 1) / sizeof(Word));
+    }
+
+public:
+    PackedHybridDdSpec()
+            : arraySize(-1), elementBits(-1), dataWords(-1) {
+    }
+
+    int datasize() const {
+        return dataWords * sizeof(Word);
+    }
+
+    int get_root(void* p) {
+        Word* q = static_cast<Word*>(p);
+        for (int k = 0; k < dataWords; ++k) {
+            q[k] = 0;
+        }
+        if (elementBits == 0) {
+            return this->entity().getRoot(s_state(p), a_state(p));
+        }
+
+        Word local[LOCAL_WORDS] = {};
+        std::vector<Word> heap;
+        A_State* a = workArray(local, heap);
+        int i = this->entity().getRoot(s_state(p), a);
+        if (i > 0) pack(a, p);
+        return i;
+    }
+
+    int get_child(void* p, int level, bool take) {
+        if (elementBits == 0) {
+            return this->entity().getChild(s_state(p), a_state(p), level,
+                    take);
+        }
+
+        Word local[LOCAL_WORDS];
+        std::vector<Word> heap;
+        A_State* a = workArray(local, heap);
+        unpack(p, a);
+        int i = this->entity().getChild(s_state(p), a, level, take);
+        if (i > 0) pack(a, p);
+        return i;
+    }
+
+    void get_copy(void* to, void const* from) {
+        Word const* pa = static_cast<Word const*>(from);
+        Word const* pz = pa + dataWords;
+        Word* qa = static_cast<Word*>(to);
+        while (pa != pz) {
+            *qa++ = *pa++;
+        }
+    }
+
+    void destruct(void* p) {
+    }
+
+    void destructLevel(int level) {
+    }
+
+    size_t hash_code(void const* p) const {
+        Word const* pa = static_cast<Word const*>(p);
+        Word const* pz = pa + dataWords;
+        size_t h = 0;
+        while (pa != pz) {
+            h += *pa++;
+            h *= 314159257;
+        }
+        return h;
+    }
+
+    bool equal_to(void const* p, void const* q) const {
+        Word const* pa = static_cast<Word const*>(p);
+        Word const* qa = static_cast<Word const*>(q);
+        Word const* pz = pa + dataWords;
+        while (pa != pz) {
+            if (*pa++ != *qa++) return false;
+        }
+        return true;
+    }
+
+    std::ostream& print(std::ostream& os, void const* p) const {
+        Word local[LOCAL_WORDS];
+        std::vector<Word> heap;
+        A_State const* a = a_state(p);
+        if (elementBits > 0) {
+            A_State* b = workArray(local, heap);
+            unpack(p, b);
+            a = b;
+        }
+        os << "[" << s_state(p) << ":";
+        for (int i = 0; i < arraySize; ++i) {
+            if (i > 0) os << ",";
+            os << a[i];
+        }
+        return os << "]";
+    }
+};
+
 /**
  * Abstract class of DD specifications using @p DdNodeId states.
  * Every implementation must have the following functions:
@@ -9,9 +9,11 @@
 
 #include <cassert>
 #include <ostream>
+#include <stdint.h>
 #include <vector>
 
 #include "DdBuilder.hpp"
+#include "DdBuilderExternal.hpp"
 #include "DdEval.hpp"
 #include "DdNode.hpp"
 #include "DdNodeTable.hpp"
@@ -100,15 +102,113 @@ public:
 //        if (doReduce) reduce();
 //    }
 
+    /**
+     * Gets the memory size for pending states in construction.
+     * @return the size in bytes, or 0 for no limit.
+     */
+    static size_t spillThreshold() {
+        return spillThreshold_();
+    }
+
+    /**
+     * Sets the memory size for pending states in construction.
+     * Beyond it, they are spilled to a temporary file.
+     * @param bytes the size in bytes, or 0 for no limit.
+     * @return the previous size.
+     */
+    static size_t spillThreshold(size_t bytes) {
+        size_t& t = spillThreshold_();
+        size_t old = t;
+        t = bytes;
+        return old;
+    }
+
+    /**
+     * Sets the lower limit to which smaller spill thresholds are raised.
+     * A lower one also merges fewer runs at a time.
+     * @param bytes the size in bytes, or 0 for the default.
+     * @return the previous size.
+     */
+    static size_t minSpillThreshold(size_t bytes) {
+        size_t& t = minSpillThreshold_();
+        size_t old = t;
+        t = bytes;
+        return old;
+    }
+
+    /**
+     * Statistics of a construction or subsetting.
+     */
+    struct Statistics {
+        size_t numNodes;      ///< the number of nodes before reduction.
+        int stateSize;        ///< the size of a state in bytes.
+        int numThreads;       ///< the number of threads used.
+        uint64_t spilledSize; ///< the number of bytes spilled to a file.
+        int mergePasses; ///< the max number of merge passes over a level.
+
+        Statistics()
+                : numNodes(0), stateSize(0), numThreads(0), spilledSize(0),
+                  mergePasses(0) {
+        }
+    };
+
+    /**
+     * Gets the statistics of the last construction or subsetting.
+     * @return the statistics.
+     */
+    static Statistics const& lastStatistics() {
+        return lastStatistics_();
+    }
+
 private:
+    static size_t& spillThreshold_() {
+        static size_t threshold = 0;
+        return threshold;
+    }
+
+    static size_t& minSpillThreshold_() {
+        static size_t threshold = 0;
+        return threshold;
+    }
+
+    static Statistics& lastStatistics_() {
+        static Statistics stats;
+        return stats;
+    }
+
     template<typename SPEC>
     void construct_(SPEC& spec) {
+        DdNodeTable& table = nodeTable.privateEntity();
+
+        if (spillThreshold_() > 0) {
+            DdBuilderExternal<SPEC> zc(spec, table, spillThreshold_(),
+                    minSpillThreshold_());
+            constructBy_(zc, spec);
+            lastStatistics_().spilledSize = zc.spilledSize();
+            lastStatistics_().mergePasses = zc.mergePasses();
+            return;
+        }
+#ifdef _OPENMP
+        if (SPEC::isThreadSafe && omp_get_max_threads() >= 2) {
+            DdBuilderMP<SPEC> zc(spec, table);
+            constructBy_(zc, spec);
+            return;
+        }
+#endif
+        DdBuilder<SPEC> zc(spec, table);
+        constructBy_(zc, spec);
+    }
+
+    template<typename BUILDER, typename SPEC>
+    void constructBy_(BUILDER& zc, SPEC& spec) {
         MessageHandler mh;
         mh.begin("construction") << " of " << typenameof(spec);
-        DdBuilder<SPEC> zc(spec, nodeTable.privateEntity());
         zc.initialize(root);
 
         if (root.row > 0) {
+            if (zc.numThreads() >= 2) {
+                mh << " (#thread = " << zc.numThreads() << ")";
+            }
             mh.setSteps(root.row);
             for (int i = root.row; i > 0; --i) {
                 zc.construct(i);
@@ -119,25 +219,43 @@ private:
             mh << " ...";
         }
 
-        mh.end(nodeTable->totalSize());
+        mh.end(nodeTable->totalSize(), width());
+        setStatistics_(spec, zc.numThreads());
+    }
+
+    template<typename SPEC>
+    void setStatistics_(SPEC& spec, int numThreads) {
+        Statistics& stats = lastStatistics_();
+        stats = Statistics();
+        stats.numNodes = nodeTable->totalSize();
+        stats.stateSize = spec.datasize();
+        stats.numThreads = numThreads;
     }
 
     template<typename SPEC>
     void subset_(SPEC& spec) {
+#ifdef _OPENMP
+        if (SPEC::isThreadSafe && omp_get_max_threads() >= 2
+                && root.row < 65535) {
+            subsetBy_<ZddSubsetterMP<SPEC> >(spec);
+            return;
+        }
+#endif
+        subsetBy_<ZddSubsetter<SPEC> >(spec);
+    }
+
+    template<typename SUBSETTER, typename SPEC>
+    void subsetBy_(SPEC& spec) {
         MessageHandler mh;
         mh.begin("subsetting") << " by " << typenameof(spec);
         DdNodeTableHandler tmpTable;
-#ifdef _OPENMPXXX
-        ZddSubsetterMP<SPEC> zs(*nodeTable, spec, tmpTable.privateEntity());
-#else
-        ZddSubsetter<SPEC> zs(*nodeTable, spec, tmpTable.privateEntity());
-#endif
+        SUBSETTER zs(*nodeTable, spec, tmpTable.privateEntity());
         zs.initialize(root);
 
         if (root.row > 0) {
-#ifdef _OPENMPXXX
-            mh << " (#thread = " << zs.numThreads() << ")";
-#endif
+            if (zs.numThreads() >= 2) {
+                mh << " (#thread = " << zs.numThreads() << ")";
+            }
             mh.setSteps(root.row);
             for (int i = root.row; i > 0; --i) {
                 zs.subset(i);
@@ -150,17 +268,70 @@ private:
         }
 
         nodeTable = tmpTable;
-        mh.end(nodeTable->totalSize());
+        mh.end(nodeTable->totalSize(), width());
+        setStatistics_(spec, zs.numThreads());
     }
 
-public:
+    /**
+     * Evaluator of reduced levels.
+     * A reduced level is released as soon as it is evaluated.
+     */
+    template<typename T>
+    struct ReducedEvaluator {
+        typedef typename T::Val Val;
+        T& eval;
+        int const top;
+        DataTable<Val> work;
+
+        ReducedEvaluator(T& eval, int n)
+                : eval(eval), top(n), work(n + 1) {
+            work.initRow(0, 2);
+            eval.evalTerminal(work[0][0], 0);
+            eval.evalTerminal(work[0][1], 1);
+        }
+
+        void operator()(DdNodeTable& reduced, DdNodeTable const& table,
+                int i) {
+            size_t const m = reduced.rowSize(i);
+            DdNode const* const tt = reduced[i];
+            Val* w = work.initRow(i, m);
+            eval.initializeLevel(i, m);
+
+            for (size_t j = 0; j < m; ++j) {
+                DdNodeId f0 = tt[j].branch[0];
+                DdNodeId f1 = tt[j].branch[1];
+                eval.evalNode(w[j], i, work[f0.row][f0.col], f0.row,
+                        work[f1.row][f1.col], f1.row);
+            }
+            reduced.clear(i);
+
+            if (i == top) return; // the root may be redirected below
+            MyVector<int> const& levels = table.lowerLevels(i);
+            for (int const* t = levels.begin(); t != levels.end(); ++t) {
+                work.clear(*t);
+                eval.destructLevel(*t);
+            }
+        }
+    };
+
+    /**
+     * Keeper of reduced levels.
+     */
+    struct ReducedKeeper {
+        void operator()(DdNodeTable&, DdNodeTable const&, int) {
+        }
+    };
+
     /**
      * Reduce as a ZDD.
+     * @param emit called for each reduced level bottom-up.
      */
-    void reduce() {
+    template<typename EMIT>
+    void reduce_(EMIT& emit) {
         DdNodeTable& table = nodeTable.privateEntity();
         MessageHandler mh;
         mh.begin("reduction") << " ";
+        size_t total = 0;
 
         int const n = table.numRows() - 1;
         DdNodeTableHandler tmpTableHandler(n + 1);
@@ -289,12 +460,45 @@ public:
                     }
                 }
             }
+
+            total += mm;
+            emit(tmpTable, table, i);
             mh.step();
         }
 
-        nodeTable = tmpTableHandler;
         root = newIdTable[root.row][root.col];
-        mh.end(nodeTable->totalSize());
+        nodeTable = tmpTableHandler;
+        mh.end(total);
+    }
+
+public:
+    /**
+     * Reduce as a ZDD.
+     */
+    void reduce() {
+        ReducedKeeper keeper;
+        reduce_(keeper);
+    }
+
+    /**
+     * Reduces as a ZDD and evaluates the result at the same time.
+     * Each level is released as soon as it is evaluated, so that
+     * the structure is left empty.
+     * @param eval the evaluator.
+     * @return the value of the root.
+     */
+    template<typename T>
+    typename T::RetVal reduceAndEvaluate(T eval) {
+        int const n = nodeTable->numRows() - 1;
+        eval.initialize(root.row);
+        ReducedEvaluator<T> re(eval, n);
+        reduce_(re);
+
+        typename T::Val v = re.work[root.row][root.col];
+        re.work.init(1);
+        nodeTable.init();
+        root = 0;
+        return eval.getValue(v);
     }
 
     /**
@@ -515,8 +719,8 @@ public:
         mh << "\nMP4: " << etc4 << "\n";
         mh << "\nMP5: " << etc5 << "\n";
 
-        nodeTable = tmpTableHandler;
         root = newIdTable[root.row][root.col];
+        nodeTable = tmpTableHandler;
         mh.end(nodeTable->totalSize());
     }
 
@@ -544,6 +748,15 @@ public:
         return nodeTable->totalSize();
     }
 
+    /**
+     * Gets the largest number of nonterminal nodes at a level.
+     * Before reduction, it is the peak width of the construction.
+     * @return the largest number of nonterminal nodes at a level.
+     */
+    size_t width() const {
+        return nodeTable->maxRowSize();
+    }
+
     /**
      * Evaluates the DD from the bottom to the top.
      * @param eval the driver class that implements <tt>evalTerminal(bool b, Val& v)</tt> and
@@ -568,6 +781,7 @@ public:
 
         for (int i = 1; i <= n; ++i) {
             size_t m = nodeTable->rowSize(i);
+            eval.initializeLevel(i, m);
             for (size_t j = 0; j < m; ++j) {
                 DdNodeId f0 = (*nodeTable)[i][j].branch[0];
                 DdNodeId f1 = (*nodeTable)[i][j].branch[1];
@@ -24,6 +24,9 @@
  * ZBDD nodes at level @a i + @p offset.
  * When the ZBDD variables are not enough, they are
  * created automatically by BDD_NewVar().
+ * Nodes are made directly in the kernel, as the child nodes of a node
+ * are always at lower levels; the kernel tables are enlarged for each
+ * level in advance.
  */
 struct ToZBDD: public DdEval<ToZBDD,ZBDD> {
     int const offset;
@@ -39,6 +42,12 @@ public:
         }
     }
 
+    void initializeLevel(int level, size_t size) const {
+        if (level + offset > 0) {
+            BDD_Reserve(BDD_VarOfLev(level + offset), size);
+        }
+    }
+
     void evalTerminal(ZBDD& f, bool one) const {
         f = ZBDD(one ? 1 : 0);
     }
@@ -49,7 +58,7 @@ public:
             f = f0;
         }
         else {
-            f = f0 + f1.Change(BDD_VarOfLev(level + offset));
+            f = ZBDD_Node(BDD_VarOfLev(level + offset), f0, f1);
         }
     }
 };
@@ -64,6 +64,8 @@ protected:
     }
 
 public:
+    static bool const isThreadSafe = S1::isThreadSafe && S2::isThreadSafe;
+
     BinaryOperation(S1& s1, S2& s2)
             : spec1(s1), spec2(s2), stateWords1(wordSize(spec1.datasize())),
               stateWords2(wordSize(spec2.datasize())) {
@@ -227,6 +229,8 @@ class ZddIntersection: public PodArrayDdSpec<ZddIntersection<S1,S2>,size_t> {
     }
 
 public:
+    static bool const isThreadSafe = S1::isThreadSafe && S2::isThreadSafe;
+
     ZddIntersection(S1 const& s1, S2 const& s2)
             : spec1(s1), spec2(s2), stateWords1(wordSize(spec1.datasize())),
               stateWords2(wordSize(spec2.datasize())) {
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <iostream>
@@ -17,7 +18,7 @@
 #include "../util/Graph.hpp"
 #include "../util/IntSubset.hpp"
 
-class DegreeConstraint: public PodArrayDdSpec<DegreeConstraint,int16_t> {
+class DegreeConstraint: public PackedArrayDdSpec<DegreeConstraint,int16_t> {
     typedef int16_t Mate;
 
     Graph const& graph;
@@ -47,12 +48,20 @@ class DegreeConstraint: public PodArrayDdSpec<DegreeConstraint,int16_t> {
     }
 
 public:
-    DegreeConstraint(Graph const& graph, IntSubset const* c = 0)
+    DegreeConstraint(Graph const& graph, IntSubset const* c = 0,
+            bool packed = false)
             : graph(graph), n(graph.edgeSize()),
               mateSize(graph.maxFrontierSize()) {
-        setArraySize(mateSize);
-
         int m = graph.vertexSize();
+        std::vector<int> degree(m + 1);
+        int maxDegree = 0;
+        for (int a = 0; a < n; ++a) {
+            Graph::EdgeInfo const& e = graph.edgeInfo(a);
+            maxDegree = std::max(maxDegree, ++degree[e.v1]);
+            maxDegree = std::max(maxDegree, ++degree[e.v2]);
+        }
+        setArraySize(mateSize, packed ? PackedBits::bitsFor(maxDegree) : 0);
+
         constraints.resize(m + 1);
         for (int v = 1; v <= m; ++v) {
             constraints[v] = c;
@@ -69,6 +78,14 @@ public:
         constraints[graph.getVertex(v)] = c;
     }
 
+    uint64_t packElement(Mate degree) const {
+        return degree;
+    }
+
+    Mate unpackElement(uint64_t x) const {
+        return Mate(x);
+    }
+
     int getRoot(Mate* mate) const {
         for (int k = 0; k < mateSize; ++k) {
             mate[k] = 0;
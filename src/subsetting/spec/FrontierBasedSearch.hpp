@@ -19,14 +19,16 @@
 
 struct FrontierBasedSearchCount {
     int16_t uec; ///< uncolored edge component counter.
+    int16_t ucc; ///< unfinished color counter.
 
-    FrontierBasedSearchCount(int16_t uncoloredEdgeComponents)
-            : uec(uncoloredEdgeComponents) {
+    FrontierBasedSearchCount(int16_t uncoloredEdgeComponents,
+            int16_t unfinishedColors)
+            : uec(uncoloredEdgeComponents), ucc(unfinishedColors) {
     }
 
     friend std::ostream& operator<<(std::ostream& os,
             FrontierBasedSearchCount const& o) {
-        return os << o.uec;
+        return os << o.uec << "/" << o.ucc;
     }
 };
 
@@ -69,6 +71,28 @@ public:
         nxt = 0;
     }
 
+    /**
+     * Encodes this into an integer of hocBits + nxtBits bits.
+     * @param hocMin the lower bound of offsets to head or color.
+     * @param hocMax the upper bound of offsets to color.
+     * @param nxtBits the number of bits for offsets to next.
+     */
+    uint64_t pack(int hocMin, int hocMax, int nxtBits) const {
+        int h = (hoc >= UNCOLORED) ? hocMax + 1 + (hoc - UNCOLORED) : hoc;
+        assert(hocMin <= h && h <= hocMax + 2);
+        assert(0 <= nxt && nxt < (1 << nxtBits));
+        return (uint64_t(h - hocMin) << nxtBits) | uint64_t(nxt);
+    }
+
+    static FrontierBasedSearchMate unpack(uint64_t x, int hocMin, int hocMax,
+            int nxtBits) {
+        int h = int(x >> nxtBits) + hocMin;
+        FrontierBasedSearchMate o((h > hocMax) ? UNCOLORED + (h - hocMax - 1)
+                                               : h);
+        o.nxt = Offset(x & ((uint64_t(1) << nxtBits) - 1));
+        return o;
+    }
+
     bool isHead() const {
         return hoc >= 0;
     }
@@ -232,7 +256,7 @@ public:
     }
 };
 
-class FrontierBasedSearch: public PodHybridDdSpec<FrontierBasedSearch,
+class FrontierBasedSearch: public PackedHybridDdSpec<FrontierBasedSearch,
         FrontierBasedSearchCount,FrontierBasedSearchMate> {
     typedef FrontierBasedSearchCount Count;
     typedef FrontierBasedSearchMate Mate;
@@ -244,11 +268,18 @@ class FrontierBasedSearch: public PodHybridDdSpec<FrontierBasedSearch,
     std::vector<Mate> initialMate;
     int numUEC;
     bool noLoop;
+    bool pruning;
+    int hocMin; ///< offsets to head are greater than -mateSize.
+    int hocMax; ///< offsets to color are less than m.
+    int nxtBits;
 
     int takable(Count& c, Mate const* mate, Graph::EdgeInfo const& e) const {
         Mate const& w1 = mate[e.v1 - e.v0];
         Mate const& w2 = mate[e.v2 - e.v0];
 
+        // no component can be finished after all have been finished
+        if (pruning && c.uec == 0 && c.ucc == 0) return false;
+
         // don't connect again
         if (noLoop && w1.head() == w2.head()) return false;
 
@@ -261,11 +292,13 @@ class FrontierBasedSearch: public PodHybridDdSpec<FrontierBasedSearch,
                     // don't leave the color unconnected
                     if (!w2.isColoredTail()) return false;
                     if (mate[1].findColorPredecessor(w2)) return false;
+                    --c.ucc;
                 }
                 else {
                     if (w1.isColored()) {
                         // don't leave the color unconnected
                         if (!w1.isColoredTail()) return false;
+                        --c.ucc;
                     }
                     else {
                         if (c.uec == 0) return false;
@@ -278,6 +311,7 @@ class FrontierBasedSearch: public PodHybridDdSpec<FrontierBasedSearch,
                     // don't leave the color unconnected
                     if (!w2.isColoredTail()) return false;
                     if (w2.findColorPredecessor(mate[1])) return false;
+                    --c.ucc;
                 }
                 else {
                     assert(w1.isUncoloredEdgeComponent());
@@ -310,6 +344,7 @@ class FrontierBasedSearch: public PodHybridDdSpec<FrontierBasedSearch,
             if (w1.isColored()) {
                 // don't leave the color unconnected
                 if (!w1.isColoredTail()) return false;
+                --c.ucc;
             }
             else if (c.uec >= 0 && w1.isUncoloredEdgeComponent()) {
                 if (c.uec == 0) return false;
@@ -322,6 +357,7 @@ class FrontierBasedSearch: public PodHybridDdSpec<FrontierBasedSearch,
                 // don't leave the color unconnected
                 if (!w2.isColoredTail()) return false;
                 if (mate[1].findColorPredecessor(w2)) return false;
+                --c.ucc;
             }
             else if (c.uec >= 0 && w2.isUncoloredEdgeComponent()) {
                 if (c.uec == 0) return false;
@@ -335,6 +371,7 @@ class FrontierBasedSearch: public PodHybridDdSpec<FrontierBasedSearch,
                 // don't leave the color unconnected
                 if (!w2.isColoredTail()) return false;
                 if (w2.findColorPredecessor(mate[1])) return false;
+                --c.ucc;
             }
             else {
                 assert(w1.isUncoloredEdgeComponent());
@@ -384,11 +421,14 @@ class FrontierBasedSearch: public PodHybridDdSpec<FrontierBasedSearch,
 
 public:
     FrontierBasedSearch(Graph const& graph, int numUEC = -1,
-            bool noLoop = false)
+            bool noLoop = false, bool packed = false)
             : graph(graph), m(graph.vertexSize()), n(graph.edgeSize()),
               mateSize(graph.maxFrontierSize()), initialMate(1 + m + mateSize),
-              numUEC(numUEC), noLoop(noLoop) {
-        this->setArraySize(mateSize);
+              numUEC(numUEC), noLoop(noLoop), pruning(false),
+              hocMin(-mateSize), hocMax(m),
+              nxtBits(PackedBits::bitsFor(mateSize)) {
+        int hocBits = PackedBits::bitsFor(hocMax + 2 - hocMin);
+        this->setArraySize(mateSize, packed ? hocBits + nxtBits : 0);
 
         std::vector<int> rootOfColor(graph.numColor() + 1);
         for (int v = 1; v <= m; ++v) {
@@ -402,10 +442,27 @@ public:
         }
     }
 
+    /**
+     * Enables/disables pruning of the states in which no component can be
+     * finished any more.
+     * @param flag true to enable pruning.
+     */
+    void setPruning(bool flag) {
+        pruning = flag;
+    }
+
+    uint64_t packElement(Mate const& a) const {
+        return a.pack(hocMin, hocMax, nxtBits);
+    }
+
+    Mate unpackElement(uint64_t x) const {
+        return Mate::unpack(x, hocMin, hocMax, nxtBits);
+    }
+
     int getRoot(Count& count, Mate* mate) const {
         int const v0 = graph.edgeInfo(0).v0;
 
-        count = Count(numUEC);
+        count = Count(numUEC, graph.numColor());
 
         for (int i = 0; i < mateSize; ++i) {
             mate[i] = initialMate[v0 + i];
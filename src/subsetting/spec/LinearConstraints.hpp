@@ -7,12 +7,19 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cassert>
+#include <limits>
 #include <map>
 #include <vector>
 
 #include "../dd/DdSpec.hpp"
 
+/**
+ * Linear constraints on the selected items.
+ * When @p T is an integer type, partial sums that no sum of the remaining
+ * weights can tell apart are merged into one state.
+ */
 template<typename T>
 class LinearConstraints: public PodArrayDdSpec<LinearConstraints<T>,T> {
     struct CheckItem {
@@ -20,6 +27,7 @@ class LinearConstraints: public PodArrayDdSpec<LinearConstraints<T>,T> {
         T weight;
         T addMin;
         T addMax;
+        T step; ///< GCD of the remaining weights, or 0 if not integral.
         T lowerBound;
         T upperBound;
         bool finalChoice;
@@ -28,6 +36,7 @@ class LinearConstraints: public PodArrayDdSpec<LinearConstraints<T>,T> {
                   T const& w,
                   T const& min,
                   T const& max,
+                  T const& step,
                   T const& lb,
                   T const& ub,
                   bool fc) :
@@ -35,6 +44,7 @@ class LinearConstraints: public PodArrayDdSpec<LinearConstraints<T>,T> {
                 weight(w),
                 addMin(min),
                 addMax(max),
+                step(step),
                 lowerBound(lb),
                 upperBound(ub),
                 finalChoice(fc) {
@@ -49,6 +59,42 @@ class LinearConstraints: public PodArrayDdSpec<LinearConstraints<T>,T> {
     int constraintId;
     bool isFalse;
 
+    static T gcd(T a, T b) {
+        while (b != 0) {
+            T r = a - a / b * b; // a % b for integers
+            a = b;
+            b = r;
+        }
+        return a;
+    }
+
+    static T floorDiv(T a, T b) {
+        T q = a / b;
+        if (q * b > a) --q;
+        return q;
+    }
+
+    static T ceilDiv(T a, T b) {
+        T q = a / b;
+        if (q * b < a) ++q;
+        return q;
+    }
+
+    /**
+     * Returns the representative of the partial sums equivalent to @p v.
+     * The remaining weights are multiples of the step, and so are their
+     * sums; the partial sums that keep the same range of them feasible
+     * are equivalent.
+     */
+    static T bucket(T v, CheckItem const& t) {
+        T const g = t.step;
+        T hi = t.upperBound - g * floorDiv(t.upperBound - v, g);
+        if (t.lowerBound <= v + t.addMin) return hi;
+        T lo = t.lowerBound - g * ceilDiv(t.lowerBound - v, g);
+        if (v + t.addMax <= t.upperBound) return lo;
+        return std::min(hi, lo + g - 1);
+    }
+
 public:
     LinearConstraints(int n) :
             n(n),
@@ -78,14 +124,19 @@ public:
 
         min = 0;
         max = 0;
+        T step = 0;
         bool fc = true;
         for (typename std::map<int,T>::const_iterator t = expr.begin();
                 t != expr.end(); ++t) {
             Checklist& list = checklists[t->first];
             T const& w = t->second;
-            list.push_back(CheckItem(constraintId, w, min, max, lb, ub, fc));
+            list.push_back(CheckItem(constraintId, w, min, max, step, lb, ub,
+                    fc));
             if (w > 0) max += w;
             else if (w < 0) min += w;
+            if (std::numeric_limits<T>::is_integer) {
+                step = gcd(step, w < 0 ? -w : w);
+            }
             fc = false;
         }
         ++constraintId;
@@ -151,6 +202,7 @@ public:
             if (t->lowerBound <= v + t->addMin
                 && v + t->addMax <= t->upperBound) // state compression
             v = t->lowerBound - t->addMin;
+            else if (t->step > 0) v = bucket(v, *t);
             if (t->finalChoice) v = 0;
         }
 
@@ -13,24 +13,56 @@
 
 #include "../dd/DdSpec.hpp"
 
+/**
+ * ZDD spec that skips the nodes whose 1-child is the 0-terminal.
+ * A 1-child is regarded as the 0-terminal also when none of its
+ * descendants within @p depth - 1 levels is a nonzero node.
+ */
 template<typename S>
 class ZddLookahead: public DdSpec<ZddLookahead<S> > {
     typedef S Spec;
+    typedef size_t Word;
+    static int const LOCAL_WORDS = 64; ///< work space on the stack.
 
     Spec spec;
-    std::vector<char> work;
+    int const depth;
+    int const stateWords;
+
+    /**
+     * Checks if the state can lead to a nonzero node within @p d levels.
+     * @param p the state, which is broken.
+     * @param level the level of the state.
+     * @param q the work space for @p d states.
+     */
+    bool alive(void* p, int level, int d, Word* q) {
+        if (level == 0) return false;
+        if (level < 0 || d == 0) return true;
+
+        for (int b = 1; b >= 0; --b) {
+            spec.get_copy(q, p);
+            int ii = spec.get_child(q, level, b);
+            bool ok = alive(q, ii, d - 1, q + stateWords);
+            spec.destruct(q);
+            if (ok) return true;
+        }
+        return false;
+    }
 
     int lookahead(void* p, int level) {
-        void* const q = work.data();
+        Word local[LOCAL_WORDS];
+        std::vector<Word> heap;
+        Word* q = local;
+        if (depth * stateWords > LOCAL_WORDS) {
+            heap.resize(depth * stateWords);
+            q = &heap[0];
+        }
+
         while (level >= 1) {
-            for (int b = 1; b < 2; ++b) {
-                spec.get_copy(q, p);
-                if (spec.get_child(q, level, b) != 0) {
-                    spec.destruct(q);
-                    return level;
-                }
-                spec.destruct(q);
-            }
+            spec.get_copy(q, p);
+            int ii = spec.get_child(q, level, 1);
+            bool ok = alive(q, ii, depth - 1, q + stateWords);
+            spec.destruct(q);
+            if (ok) return level;
             level = spec.get_child(p, level, 0);
         }
 
@@ -38,8 +70,12 @@ class ZddLookahead: public DdSpec<ZddLookahead<S> > {
     }
 
 public:
-    ZddLookahead(S const& s)
-            : spec(s), work(spec.datasize()) {
+    static bool const isThreadSafe = S::isThreadSafe;
+
+    ZddLookahead(S const& s, int depth = 1)
+            : spec(s), depth(depth),
+              stateWords((spec.datasize() + sizeof(Word) - 1) / sizeof(Word)) {
+        assert(depth >= 1);
     }
 
     int datasize() const {
@@ -0,0 +1,239 @@
+/*********************************************************************
+Copyright 2013  JST ERATO Minato project and other contributors
+http://www-erato.ist.hokudai.ac.jp/?language=en
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**********************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstring>
+#include <stdint.h>
+#include <vector>
+
+#include "../dd/DdSpec.hpp"
+#include "../util/Graph.hpp"
+
+/**
+ * Simpath-style search for a path between two terminals or a cycle.
+ * Every frontier vertex has a mate: FREE if it has no edge, DONE if it can
+ * have no more edges, and otherwise the offset to the other end of its
+ * path.  The other end is TO_TERMINAL when it is a terminal that has left
+ * the frontier.  The search stops as soon as the path connects both
+ * terminals or the cycle is closed, leaving the remaining edges out.
+ */
+class PathSearch: public PackedArrayDdSpec<PathSearch,int16_t> {
+    typedef int16_t Mate;
+    static Mate const FREE = 0;
+    static Mate const DONE = 32767;
+    static Mate const TO_TERMINAL = 32766;
+
+    Graph const& graph;
+    int const m;
+    int const n;
+    int const mateSize;
+    std::vector<bool> terminal;
+    bool const cycle;
+    bool const hamilton;
+
+    void shiftMate(Mate* mate, int d) const {
+        assert(d >= 0);
+        if (d > 0) {
+            std::memmove(mate, mate + d, (mateSize - d) * sizeof(*mate));
+            for (int k = mateSize - d; k < mateSize; ++k) {
+                mate[k] = FREE;
+            }
+        }
+    }
+
+    bool isEnd(Mate w) const {
+        return w != FREE && w != DONE;
+    }
+
+    bool takable(Mate const* mate, Graph::EdgeInfo const& e) const {
+        Mate w1 = mate[e.v1 - e.v0];
+        Mate w2 = mate[e.v2 - e.v0];
+
+        // a loop counts twice and is a cycle on its own
+        if (e.v1 == e.v2) return cycle && w1 == FREE;
+
+        if (w1 == DONE || w2 == DONE) return false;
+        if (terminal[e.v1] && w1 != FREE) return false;
+        if (terminal[e.v2] && w2 != FREE) return false;
+
+        // don't leave a vertex on the way with one edge
+        if (e.v1final && !terminal[e.v1] && w1 == FREE) return false;
+        if (e.v2final && !terminal[e.v2] && w2 == FREE) return false;
+
+        // don't close a cycle on the way between terminals
+        if (!cycle && w1 != TO_TERMINAL && e.v1 + w1 == e.v2) return false;
+        return true;
+    }
+
+    /**
+     * Checks the frontier when the path or cycle has been completed.
+     */
+    bool completed(Mate const* mate, Graph::EdgeInfo const& e) const {
+        for (int k = 0; k < mateSize && e.v0 + k <= m; ++k) {
+            if (isEnd(mate[k])) return false;
+            if (hamilton && mate[k] == FREE) return false;
+        }
+        return !hamilton || e.v0 + mateSize > m;
+    }
+
+    /**
+     * Takes an edge.
+     * @return 1 to go on, 0 to reject, or -1 on completion.
+     */
+    int doTake(Mate* mate, Graph::EdgeInfo const& e) const {
+        int const k1 = e.v1 - e.v0;
+        int const k2 = e.v2 - e.v0;
+        Mate const w1 = mate[k1];
+        Mate const w2 = mate[k2];
+
+        if (k1 == k2) { // loop
+            mate[k1] = DONE;
+            return completed(mate, e) ? -1 : 0;
+        }
+
+        if (w1 != FREE && w1 != TO_TERMINAL && k1 + w1 == k2) { // cycle
+            mate[k1] = mate[k2] = DONE;
+            return completed(mate, e) ? -1 : 0;
+        }
+
+        // the other ends, or -1 for terminals that have left
+        int o1 = (w1 == FREE) ? k1 : (w1 == TO_TERMINAL) ? -1 : k1 + w1;
+        int o2 = (w2 == FREE) ? k2 : (w2 == TO_TERMINAL) ? -1 : k2 + w2;
+        if (w1 != FREE) mate[k1] = DONE;
+        if (w2 != FREE) mate[k2] = DONE;
+
+        if ((o1 < 0 || terminal[e.v0 + o1])
+                && (o2 < 0 || terminal[e.v0 + o2])) { // path
+            if (o1 >= 0) mate[o1] = DONE;
+            if (o2 >= 0) mate[o2] = DONE;
+            return completed(mate, e) ? -1 : 0;
+        }
+
+        if (o1 < 0) {
+            mate[o2] = TO_TERMINAL;
+        }
+        else if (o2 < 0) {
+            mate[o1] = TO_TERMINAL;
+        }
+        else {
+            mate[o1] = o2 - o1;
+            mate[o2] = o1 - o2;
+        }
+        return 1;
+    }
+
+    bool leave(Mate* mate, int k, Graph::VertexNumber v) const {
+        Mate const w = mate[k];
+
+        if (terminal[v]) {
+            if (w == FREE) return false;
+            assert(w != DONE && w != TO_TERMINAL);
+            mate[k + w] = TO_TERMINAL;
+        }
+        else {
+            if (isEnd(w)) return false;
+            if (hamilton && w == FREE) return false;
+        }
+
+        mate[k] = FREE;
+        return true;
+    }
+
+    bool doLeave(Mate* mate, Graph::EdgeInfo const& e) const {
+        if (e.v2final && !leave(mate, e.v2 - e.v0, e.v2)) return false;
+        if (e.v1final && e.v1 != e.v2 && !leave(mate, e.v1 - e.v0, e.v1)) {
+            return false;
+        }
+        return true;
+    }
+
+public:
+    /**
+     * Constructor.
+     * @param graph the graph.
+     * @param s one terminal of paths, or 0 for cycles.
+     * @param t the other terminal of paths, or 0 for cycles.
+     * @param hamilton true to pass through all vertices.
+     * @param packed true to store states bit-packed.
+     */
+    PathSearch(Graph const& graph, Graph::VertexNumber s = 0,
+            Graph::VertexNumber t = 0, bool hamilton = false,
+            bool packed = false)
+            : graph(graph), m(graph.vertexSize()), n(graph.edgeSize()),
+              mateSize(graph.maxFrontierSize()), terminal(m + 1),
+              cycle(s == 0), hamilton(hamilton) {
+        assert(s != t || s == 0);
+        assert((s == 0) == (t == 0));
+        if (!cycle) terminal[s] = terminal[t] = true;
+        this->setArraySize(mateSize,
+                packed ? PackedBits::bitsFor(2 * mateSize + 1) : 0);
+    }
+
+    uint64_t packElement(Mate w) const {
+        if (w == FREE) return 0;
+        if (w == DONE) return 1;
+        if (w == TO_TERMINAL) return 2;
+        return w + mateSize + 2;
+    }
+
+    Mate unpackElement(uint64_t x) const {
+        if (x == 0) return FREE;
+        if (x == 1) return DONE;
+        if (x == 2) return TO_TERMINAL;
+        return Mate(int(x) - mateSize - 2);
+    }
+
+    int getRoot(Mate* mate) const {
+        for (int k = 0; k < mateSize; ++k) {
+            mate[k] = FREE;
+        }
+        return (n > 0) ? n : 0;
+    }
+
+    int getChild(Mate* mate, int level, bool take) const {
+        assert(1 <= level && level <= n);
+        int i = n - level;
+        Graph::EdgeInfo const* e = &graph.edgeInfo(i);
+
+        if (take) {
+            if (!takable(mate, *e)) return 0;
+            int r = doTake(mate, *e);
+            if (r <= 0) return r;
+        }
+
+        while (true) {
+            if (!doLeave(mate, *e)) return 0;
+            if (++i == n) return 0;
+            Graph::EdgeInfo const* ee = &graph.edgeInfo(i);
+            shiftMate(mate, ee->v0 - e->v0);
+            e = ee;
+            if (takable(mate, *e)) break;
+        }
+
+        assert(i < n);
+        return n - i;
+    }
+};
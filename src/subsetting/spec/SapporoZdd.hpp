@@ -36,6 +36,8 @@ class SapporoZdd: public ScalarDdSpec<SapporoZdd,ZBDD> {
     }
 
 public:
+    static bool const isThreadSafe = false; // SAPPOROBDD is not reentrant
+
     SapporoZdd(ZBDD const& f, int offset = 0)
             : root(f), offset(offset) {
     }
@@ -672,6 +672,327 @@ public:
         return n;
     }
 
+private:
+    typedef std::vector<std::vector<std::pair<VertexNumber,EdgeNumber> > >
+            IncidenceList;
+
+    struct OrderState {
+        std::vector<VertexNumber> order; // visited vertices
+        std::vector<VertexNumber> front; // visited vertices with rest > 0
+        std::vector<int> pos; // index in order; -1 if unvisited
+        std::vector<int> rest; // unvisited neighbors; -1 if unvisited
+        VertexNumber width;
+        uint64_t code;
+    };
+
+    struct OrderCandidate {
+        VertexNumber width;
+        VertexNumber frontier;
+        size_t state;
+        VertexNumber vertex;
+
+        bool operator<(OrderCandidate const& o) const {
+            if (width != o.width) return width < o.width;
+            if (frontier != o.frontier) return frontier < o.frontier;
+            if (state != o.state) return state < o.state;
+            return vertex < o.vertex;
+        }
+    };
+
+    static uint64_t xorshift(uint64_t& x) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        return x;
+    }
+
+    /*
+     * Returns the edges in the order of visiting their later vertices.
+     */
+    static std::vector<EdgeNumber> edgeOrder(OrderState const& s,
+            IncidenceList const& incident) {
+        std::vector<EdgeNumber> edges;
+        for (size_t i = 0; i < s.order.size(); ++i) {
+            VertexNumber v = s.order[i];
+            std::vector<std::pair<int,EdgeNumber> > back;
+            for (size_t k = 0; k < incident[v].size(); ++k) {
+                VertexNumber u = incident[v][k].first;
+                if (s.pos[u] <= s.pos[v]) {
+                    back.push_back(
+                            std::make_pair(s.pos[u], incident[v][k].second));
+                }
+            }
+            std::sort(back.begin(), back.end());
+            for (size_t k = 0; k < back.size(); ++k) {
+                edges.push_back(back[k].second);
+            }
+        }
+        return edges;
+    }
+
+    /*
+     * Returns the breadth-first order from v, which restarts from the
+     * smallest unvisited vertex for each remaining connected component.
+     * The distance from the starting vertex is stored to *level.
+     */
+    static OrderState bfsOrder(VertexNumber v, IncidenceList const& incident,
+            std::vector<int>* level) {
+        VertexNumber const n = incident.size() - 1;
+        OrderState s;
+        s.pos.assign(n + 1, -1);
+        level->assign(n + 1, -1);
+        VertexNumber next = 1;
+        while (true) {
+            (*level)[v] = 0;
+            s.pos[v] = s.order.size();
+            s.order.push_back(v);
+            for (size_t i = s.pos[v]; i < s.order.size(); ++i) {
+                VertexNumber u = s.order[i];
+                for (size_t k = 0; k < incident[u].size(); ++k) {
+                    VertexNumber w = incident[u][k].first;
+                    if (s.pos[w] >= 0) continue;
+                    (*level)[w] = (*level)[u] + 1;
+                    s.pos[w] = s.order.size();
+                    s.order.push_back(w);
+                }
+            }
+            while (next <= n && s.pos[next] >= 0) {
+                ++next;
+            }
+            if (next > n) break;
+            v = next;
+        }
+        return s;
+    }
+
+    /*
+     * Returns maxFrontierSize() that update() would give with edges in the
+     * given order, where vertices are numbered by leaving order.  The sum
+     * of squared frontier sizes is stored to *area if area is not null.
+     */
+    VertexNumber frontierSizeOf(std::vector<EdgeNumber> const& edges,
+            double* area = 0) const {
+        VertexNumber const n = vMax;
+        std::vector<EdgeNumber> lastEdge(n + 1, -1);
+        for (size_t i = 0; i < edges.size(); ++i) {
+            EdgeInfo const& e = edgeInfo_[edges[i]];
+            lastEdge[e.v1] = i;
+            lastEdge[e.v2] = i;
+        }
+        std::vector<VertexNumber> number(n + 1);
+        std::vector<EdgeNumber> leaving; // lastEdge in numbering order
+        for (size_t i = 0; i < edges.size(); ++i) {
+            EdgeInfo const& e = edgeInfo_[edges[i]];
+            if (lastEdge[e.v1] == EdgeNumber(i) && number[e.v1] == 0) {
+                leaving.push_back(i);
+                number[e.v1] = leaving.size();
+            }
+            if (lastEdge[e.v2] == EdgeNumber(i) && number[e.v2] == 0) {
+                leaving.push_back(i);
+                number[e.v2] = leaving.size();
+            }
+        }
+        VertexNumber w = 0;
+        VertexNumber v0 = 1;
+        if (area != 0) *area = 0;
+        for (size_t i = 0; i < edges.size(); ++i) {
+            EdgeInfo const& e = edgeInfo_[edges[i]];
+            while (leaving[v0 - 1] < EdgeNumber(i)) {
+                ++v0;
+            }
+            VertexNumber m = std::max(number[e.v1], number[e.v2]) - v0 + 1;
+            if (w < m) w = m;
+            if (area != 0) *area += double(m) * m;
+        }
+        return w;
+    }
+
+public:
+    /**
+     * Finds an edge order with a small maxFrontierSize().  Vertex orders
+     * are searched and each vertex processes the edges to the vertices
+     * visited before it.  Candidates are breadth-first orders from
+     * pseudo-peripheral vertices and the results of a beam search, in
+     * which the next vertex is a neighbor of the oldest vertex on the
+     * frontier and states are ranked by the largest frontier so far and
+     * then by the current frontier.  The best candidate by the exact
+     * maxFrontierSize() is improved by local search moving one vertex at a
+     * time.
+     * @param beamWidth the number of states kept at each step.
+     * @param source the vertex visited first, or 0 to choose any vertex.
+     * @return edge numbers in the new order.
+     */
+    std::vector<EdgeNumber> frontierOrder(int beamWidth = 16,
+            VertexNumber source = 0) const {
+        assert(beamWidth >= 1);
+        assert(0 <= source && source <= vMax);
+        VertexNumber const n = vMax;
+        if (n == 0) return std::vector<EdgeNumber>();
+
+        IncidenceList incident(n + 1);
+        std::vector<int> degree(n + 1);
+        for (EdgeNumber a = 0; a < edgeSize(); ++a) {
+            EdgeInfo const& e = edgeInfo_[a];
+            incident[e.v1].push_back(std::make_pair(e.v2, a));
+            if (e.v1 == e.v2) continue;
+            incident[e.v2].push_back(std::make_pair(e.v1, a));
+            ++degree[e.v1];
+            ++degree[e.v2];
+        }
+
+        uint64_t random = 88172645463325252ULL;
+        std::vector<uint64_t> code(n + 1);
+        for (VertexNumber v = 1; v <= n; ++v) {
+            code[v] = xorshift(random);
+        }
+
+        std::vector<OrderState> beam(1);
+        beam[0].pos.assign(n + 1, -1);
+        beam[0].rest.assign(n + 1, -1);
+        beam[0].width = 0;
+        beam[0].code = 0;
+
+        for (VertexNumber step = 0; step < n; ++step) {
+            std::vector<OrderCandidate> cands;
+
+            for (size_t i = 0; i < beam.size(); ++i) {
+                OrderState const& s = beam[i];
+                std::vector<VertexNumber> next;
+                if (!s.front.empty()) {
+                    VertexNumber u = s.front.front();
+                    for (size_t k = 0; k < incident[u].size(); ++k) {
+                        VertexNumber v = incident[u][k].first;
+                        if (s.pos[v] < 0) next.push_back(v);
+                    }
+                }
+                else if (step == 0 && source != 0) {
+                    next.push_back(source);
+                }
+                else { // start a new connected component
+                    for (VertexNumber v = 1; v <= n; ++v) {
+                        if (s.pos[v] < 0) next.push_back(v);
+                    }
+                }
+
+                VertexNumber frontier = s.front.size();
+                for (size_t j = 0; j < next.size(); ++j) {
+                    VertexNumber v = next[j];
+                    int back = 0;
+                    int leaving = 0;
+                    for (size_t k = 0; k < incident[v].size(); ++k) {
+                        VertexNumber u = incident[v][k].first;
+                        if (u == v || s.pos[u] < 0) continue;
+                        ++back;
+                        if (s.rest[u] == 1) ++leaving;
+                    }
+                    OrderCandidate c;
+                    c.width = std::max(s.width, frontier + 1);
+                    c.frontier = frontier - leaving
+                            + (back < degree[v] ? 1 : 0);
+                    c.state = i;
+                    c.vertex = v;
+                    cands.push_back(c);
+                }
+            }
+
+            std::sort(cands.begin(), cands.end());
+            std::vector<OrderState> nextBeam;
+            std::set<uint64_t> codes;
+            for (size_t j = 0; j < cands.size(); ++j) {
+                if (nextBeam.size() >= size_t(beamWidth)) break;
+                OrderState const& s = beam[cands[j].state];
+                VertexNumber v = cands[j].vertex;
+                if (!codes.insert(s.code ^ code[v]).second) continue;
+
+                nextBeam.push_back(s);
+                OrderState& t = nextBeam.back();
+                t.pos[v] = t.order.size();
+                t.order.push_back(v);
+                t.rest[v] = degree[v];
+                t.width = cands[j].width;
+                t.code ^= code[v];
+                for (size_t k = 0; k < incident[v].size(); ++k) {
+                    VertexNumber u = incident[v][k].first;
+                    if (u == v || t.pos[u] < 0) continue;
+                    --t.rest[u];
+                    --t.rest[v];
+                }
+                std::vector<VertexNumber> front;
+                for (size_t k = 0; k < t.front.size(); ++k) {
+                    if (t.rest[t.front[k]] > 0) front.push_back(t.front[k]);
+                }
+                if (t.rest[v] > 0) front.push_back(v);
+                t.front.swap(front);
+            }
+            beam.swap(nextBeam);
+        }
+
+        // Pseudo-peripheral vertices by George and Liu's algorithm
+        VertexNumber v = source;
+        if (v == 0) {
+            v = 1;
+            for (VertexNumber u = 2; u <= n; ++u) {
+                if (degree[u] < degree[v]) v = u;
+            }
+        }
+        std::vector<int> level;
+        int eccentricity = -1;
+        for (int i = 0; i < beamWidth; ++i) {
+            beam.push_back(bfsOrder(v, incident, &level));
+            if (source != 0) break;
+            int e = *std::max_element(level.begin(), level.end());
+            if (e <= eccentricity) break;
+            eccentricity = e;
+            VertexNumber u = 0;
+            for (VertexNumber w = 1; w <= n; ++w) {
+                if (level[w] == e && (u == 0 || degree[w] < degree[u])) u = w;
+            }
+            v = u;
+        }
+
+        OrderState best;
+        VertexNumber bestWidth = INT_MAX;
+        double bestArea = 0;
+        for (size_t i = 0; i < beam.size(); ++i) {
+            double area;
+            VertexNumber w = frontierSizeOf(edgeOrder(beam[i], incident),
+                    &area);
+            if (w < bestWidth || (w == bestWidth && area < bestArea)) {
+                best = beam[i];
+                bestWidth = w;
+                bestArea = area;
+            }
+        }
+
+        for (int i = 0; i < 64 * beamWidth && n >= 2; ++i) {
+            int from = xorshift(random) % n;
+            int to = from + int(xorshift(random) % (2 * bestWidth + 1))
+                    - bestWidth;
+            if (to == from || to < 0 || to >= n) continue;
+            if (source != 0 && (from <= 1 || to <= 1)) continue;
+
+            OrderState s = best;
+            VertexNumber v = s.order[from];
+            s.order.erase(s.order.begin() + from);
+            s.order.insert(s.order.begin() + to, v);
+            for (int k = std::min(from, to); k <= std::max(from, to); ++k) {
+                s.pos[s.order[k]] = k;
+            }
+            double area;
+            VertexNumber w = frontierSizeOf(edgeOrder(s, incident), &area);
+            if (w < bestWidth || (w == bestWidth && area <= bestArea)) {
+                best.order.swap(s.order);
+                best.pos.swap(s.pos);
+                bestWidth = w;
+                bestArea = area;
+            }
+        }
+
+        std::vector<EdgeNumber> edges = edgeOrder(best, incident);
+        assert(edges.size() == size_t(edgeSize()));
+        return edges;
+    }
+
     void clearColors() {
         name2color.clear();
         virtualMate_.clear();
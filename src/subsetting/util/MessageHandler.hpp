@@ -245,6 +245,12 @@ public:
         return end("", "<" + to_string(n) + ">");
     }
 
+    MessageHandler_& end(size_t n, size_t width) {
+        if (!enabled) return *this;
+        return end("", "<" + to_string(n) + ", width " + to_string(width)
+                + ">");
+    }
+
     int col() const {
         return column;
     }
@@ -0,0 +1,106 @@
+/*********************************************************************
+Copyright 2013  JST ERATO Minato project and other contributors
+http://www-erato.ist.hokudai.ac.jp/?language=en
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**********************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstdio>
+#include <stdexcept>
+#include <stdint.h>
+#ifndef _WIN32
+#include <sys/types.h>
+#endif
+
+/**
+ * Temporary file for data that do not fit in memory.
+ * Data are appended to the end and read at any offset.  The file is
+ * removed automatically when it is closed.
+ */
+class SpillFile {
+    std::FILE* fp;
+    uint64_t size_;
+
+    void seek(uint64_t offset) {
+#ifdef _WIN32
+        int e = _fseeki64(fp, offset, SEEK_SET);
+#else
+        int e = fseeko(fp, off_t(offset), SEEK_SET);
+#endif
+        if (e != 0) throw std::runtime_error("Can't seek a temporary file!");
+    }
+
+    SpillFile(SpillFile const&);
+    SpillFile& operator=(SpillFile const&);
+
+public:
+    SpillFile()
+            : fp(0), size_(0) {
+    }
+
+    ~SpillFile() {
+        if (fp != 0) std::fclose(fp);
+    }
+
+    /**
+     * Gets the number of bytes written so far.
+     * @return the file size.
+     */
+    uint64_t size() const {
+        return size_;
+    }
+
+    /**
+     * Appends data to the end of the file.
+     * @param p pointer to the data.
+     * @param n the number of bytes.
+     * @return the offset of the data.
+     */
+    uint64_t append(void const* p, size_t n) {
+        if (fp == 0) {
+            fp = std::tmpfile();
+            if (fp == 0) throw std::runtime_error(
+                    "Can't create a temporary file!");
+        }
+
+        uint64_t offset = size_;
+        seek(offset);
+        if (std::fwrite(p, 1, n, fp) != n) throw std::runtime_error(
+                "Can't write a temporary file!");
+        size_ += n;
+        return offset;
+    }
+
+    /**
+     * Reads data.
+     * @param offset the offset of the data.
+     * @param p pointer to the buffer.
+     * @param n the number of bytes.
+     */
+    void read(uint64_t offset, void* p, size_t n) {
+        assert(offset + n <= size_);
+        seek(offset);
+        if (std::fread(p, 1, n, fp) != n) throw std::runtime_error(
+                "Can't read a temporary file!");
+    }
+};
@@ -209,6 +209,12 @@ class TestGraphSet {
     this->rooted_paths();
     this->hamilton_paths();
     this->large();
+    this->num_threads();
+    this->frontier_order();
+    this->compact_states();
+    this->lookahead();
+    this->spill_threshold();
+    this->path_search();
   }
 
   void any_subgraphs() {
@@ -448,6 +454,236 @@ class TestGraphSet {
                              0, true);
     assert(ss.size() == "789360053252");
   }
+
+  void num_threads() {  // the threads are used, and results do not change
+    setup_large(5);
+    vector<vector<vertex_t> > vertex_groups = V("{{1, 25}}");
+    map<vertex_t, Range> path_degrees, tree_degrees;
+    for (vector<vertex_t>::const_iterator v = vertices.begin();
+         v != vertices.end(); ++v) {
+      path_degrees[*v]
+          = *v == "1" || *v == "25" ? Range(1, 2) : Range(0, 3, 2);
+      tree_degrees[*v] = Range(1, vertices.size());
+    }
+    Range num_edges(0, 10);
+    int prev = NumThreads();
+    assert(prev >= 1);
+    vector<setset> results;
+    for (int n = 1; n <= 4; ++n) {
+      NumThreads(n);
+      int m = NumThreads();  // always 1 without OpenMP
+      setset paths = SearchGraphs(graph, &vertex_groups, &path_degrees, NULL,
+                                  0, true);
+      assert(LastConstructionStats().num_threads == m);
+      setset trees = SearchGraphs(graph, NULL, &tree_degrees, NULL, 1, true);
+      assert(LastConstructionStats().num_threads == m);
+      setset short_paths = SearchGraphs(graph, NULL, NULL, &num_edges, 1,
+                                        false, &paths);
+      assert(LastConstructionStats().num_threads == m);
+      setset small = SearchGraphs(graph, NULL, NULL, &num_edges);
+      assert(LastConstructionStats().num_threads == m);
+      if (n == 1) {
+        assert(paths.size() == "8512");
+        assert(trees.size() == "557568000");
+        results.push_back(paths);
+        results.push_back(trees);
+        assert(short_paths.size() == "70");
+        results.push_back(short_paths);
+        assert(small.size() == "373585604");
+        results.push_back(small);
+      } else {
+        assert(paths == results[0]);
+        assert(trees == results[1]);
+        assert(short_paths == results[2]);
+        assert(small == results[3]);
+      }
+    }
+    NumThreads(prev);
+    assert(NumThreads() == prev);
+  }
+
+  void frontier_order() {
+    setup_large(5);
+    assert(MaxFrontierSize(graph) == 6);
+    vector<edge_t> shuffled;
+    for (size_t i = 0; i < graph.size(); ++i)
+      shuffled.push_back(graph[i * 7 % graph.size()]);
+    assert(MaxFrontierSize(shuffled) > 6);
+
+    vector<int> order = FrontierOrder(shuffled);
+    assert(order.size() == shuffled.size());
+    assert(set<int>(order.begin(), order.end()).size() == shuffled.size());
+    graph.clear();
+    for (vector<int>::const_iterator i = order.begin(); i != order.end(); ++i)
+      graph.push_back(shuffled[*i]);
+    assert(MaxFrontierSize(graph) <= 6);
+
+    vector<vector<vertex_t> > vertex_groups = V("{{1, 25}}");
+    map<vertex_t, Range> degrees;
+    for (vector<vertex_t>::const_iterator v = vertices.begin();
+         v != vertices.end(); ++v)
+      degrees[*v] = *v == "1" || *v == "25" ? Range(1, 2) : Range(0, 3, 2);
+    assert(SearchGraphs(graph, &vertex_groups, &degrees, NULL, 0, true).size()
+           == "8512");
+
+    vertex_t source = "13";
+    order = FrontierOrder(shuffled, 1, &source);
+    assert(order.size() == shuffled.size());
+    const edge_t& e = shuffled[order.front()];
+    assert(e.first == source || e.second == source);
+  }
+
+  void compact_states() {  // states shrink, and results do not change
+    setup_large(5);
+    vector<vector<vertex_t> > vertex_groups = V("{{1, 25}, {5}, {21}}");
+    map<vertex_t, Range> path_degrees, tree_degrees;
+    for (vector<vertex_t>::const_iterator v = vertices.begin();
+         v != vertices.end(); ++v) {
+      path_degrees[*v]
+          = *v == "1" || *v == "25" ? Range(1, 2) : Range(0, 3, 2);
+      tree_degrees[*v] = Range(1, vertices.size());
+    }
+    setset paths = SearchGraphs(graph, &vertex_groups, &path_degrees);
+    int path_size = LastConstructionStats().state_size;
+    setset trees = SearchGraphs(graph, NULL, &tree_degrees, NULL, 1, true);
+    int tree_size = LastConstructionStats().state_size;
+    setset forests = SearchGraphs(graph, &vertex_groups, NULL, NULL, 0, true);
+    int forest_size = LastConstructionStats().state_size;
+    assert(!CompactStates());
+    assert(CompactStates(true));
+    assert(SearchGraphs(graph, &vertex_groups, &path_degrees) == paths);
+    assert(LastConstructionStats().state_size < path_size);
+    assert(SearchGraphs(graph, NULL, &tree_degrees, NULL, 1, true) == trees);
+    assert(LastConstructionStats().state_size < tree_size);
+    assert(SearchGraphs(graph, &vertex_groups, NULL, NULL, 0, true)
+           == forests);
+    assert(LastConstructionStats().state_size < forest_size);
+    assert(CompactStates(false));
+    assert(!CompactStates(false));
+  }
+
+  void lookahead() {  // dead states are pruned, and results do not change
+    setup_large(5);
+    vector<vector<vertex_t> > vertex_groups = V("{{1, 25}, {5, 21}}");
+    map<vertex_t, Range> path_degrees, cycle_degrees;
+    for (vector<vertex_t>::const_iterator v = vertices.begin();
+         v != vertices.end(); ++v) {
+      path_degrees[*v] = *v == "1" || *v == "25" || *v == "5" || *v == "21"
+          ? Range(1, 2) : Range(0, 3, 2);
+      cycle_degrees[*v] = Range(0, 3, 2);
+    }
+    assert(Lookahead() == 0);
+    vector<setset> results;
+    size_t prev_nodes = 0;
+    for (int d = 0; d <= 3; ++d) {
+      assert(Lookahead(d) == (d > 0 ? d - 1 : 0));
+      setset paths = SearchGraphs(graph, &vertex_groups, &path_degrees, NULL,
+                                  0, true);
+      setset cycles = SearchGraphs(graph, NULL, &cycle_degrees, NULL, 1);
+      size_t nodes = LastConstructionStats().num_nodes;
+      assert(d == 0 || (d == 1 ? nodes < prev_nodes : nodes <= prev_nodes));
+      prev_nodes = nodes;
+      setset forests = SearchGraphs(graph, &vertex_groups, NULL, NULL, 1,
+                                    true);
+      if (d == 0) {
+        assert(cycles.size() == "9349");
+        results.push_back(paths);
+        results.push_back(cycles);
+        results.push_back(forests);
+      } else {
+        assert(paths == results[0]);
+        assert(cycles == results[1]);
+        assert(forests == results[2]);
+      }
+    }
+    assert(Lookahead(0) == 3);
+    assert(Lookahead() == 0);
+  }
+
+  void spill_threshold() {  // states beyond the threshold go to a file
+    setup_large(5);
+    vector<vector<vertex_t> > vertex_groups = V("{{1, 25}, {5}, {21}}");
+    map<vertex_t, Range> cycle_degrees;
+    for (vector<vertex_t>::const_iterator v = vertices.begin();
+         v != vertices.end(); ++v)
+      cycle_degrees[*v] = Range(0, 3, 2);
+    setset paths = SearchGraphs(graph, &vertex_groups, NULL, NULL, 0, true);
+    setset cycles = SearchGraphs(graph, NULL, &cycle_degrees, NULL, 1);
+    assert(LastConstructionStats().spilled_size == 0);
+    assert(LastConstructionStats().merge_passes == 0);
+
+    assert(SpillThreshold() == 0);
+    assert(SpillThreshold(1) == 0);
+    assert(SearchGraphs(graph, NULL, &cycle_degrees, NULL, 1) == cycles);
+    assert(LastConstructionStats().spilled_size == 0);  // raised to 128KB
+
+    // 4KB also merges only two runs at a time
+    assert(MinSpillThreshold(4096) == 0);
+    assert(SearchGraphs(graph, &vertex_groups, NULL, NULL, 0, true) == paths);
+    assert(LastConstructionStats().spilled_size > 0);
+    assert(SearchGraphs(graph, NULL, &cycle_degrees, NULL, 1) == cycles);
+    ConstructionStats stats = LastConstructionStats();
+    assert(stats.spilled_size > 0);
+    assert(stats.merge_passes > 1);
+    assert(cycles.size() == "9349");
+    assert(MinSpillThreshold(0) == 4096);
+    assert(SpillThreshold(0) == 1);
+    assert(SpillThreshold() == 0);
+  }
+
+  void path_search() {  // must agree with the equivalent degree constraints
+    setup();
+    setset ss = SearchPaths(graph, "1", "6");
+    assert(ss.size() == "4");
+    assert(ss.find(S(3, e12, e23, e36)) != ss.end());
+    assert(ss.find(S(3, e12, e23, e56)) == ss.end());
+    ss = SearchPaths(graph, "1", "6", true);
+    assert(ss.size() == "1");
+    assert(ss.find(S(5, e14, e23, e25, e36, e45)) != ss.end());
+    ss = SearchCycles(graph);
+    assert(ss.size() == "3");
+    assert(ss.find(S(4, e12, e14, e25, e45)) != ss.end());
+    assert(ss.find(S(0)) == ss.end());
+    ss = SearchCycles(graph, true);
+    assert(ss.size() == "1");
+    assert(ss.find(S(6, e12, e14, e23, e36, e45, e56)) != ss.end());
+
+    setup_large(5);
+    const char* terminals[][2] = {{"1", "25"}, {"1", "5"}, {"7", "13"}};
+    for (int i = 0; i < 3; ++i) {
+      vector<vector<vertex_t> > vertex_groups(1);
+      vertex_groups[0].push_back(terminals[i][0]);
+      vertex_groups[0].push_back(terminals[i][1]);
+      for (int h = 0; h <= 1; ++h) {
+        map<vertex_t, Range> path_degrees, cycle_degrees;
+        for (vector<vertex_t>::const_iterator v = vertices.begin();
+             v != vertices.end(); ++v) {
+          path_degrees[*v]
+              = *v == terminals[i][0] || *v == terminals[i][1] ? Range(1, 2)
+              : h ? Range(2, 3) : Range(0, 3, 2);
+          cycle_degrees[*v] = h ? Range(2, 3) : Range(0, 3, 2);
+        }
+        assert(SearchPaths(graph, terminals[i][0], terminals[i][1], h)
+               == SearchGraphs(graph, &vertex_groups, &path_degrees, NULL, 0,
+                               true));
+        assert(SearchCycles(graph, h)
+               == SearchGraphs(graph, NULL, &cycle_degrees, NULL, 1));
+      }
+    }
+    assert(SearchCycles(graph).size() == "9349");
+
+    setset forests = SearchGraphs(graph, NULL, NULL, NULL, -1, true);
+    assert(SearchPaths(graph, "1", "25", false, &forests)
+           == SearchPaths(graph, "1", "25"));
+    assert(SearchCycles(graph, false, &forests) == setset());
+    assert(!CompactStates(true));
+    assert(SearchPaths(graph, "1", "25").size() == "8512");
+    assert(SearchCycles(graph).size() == "9349");
+    assert(CompactStates(false));
+
+    setup_large(8);
+    assert(SearchPaths(graph, "1", "64").size() == "789360053252");
+  }
 };
 
 }  // namespace graphillion
@@ -33,6 +33,7 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <vector>
 
 #include "graphillion/zdd.h"
+#include "graphillion/frozen_setset.h"
 #include "graphillion/setset.h"
 #include "graphillion/util.h"
 
@@ -91,6 +92,30 @@ vector<set<int> > V(const string& str) {
 
 #define assert_almost_equal(a, b) assert(b - 1e-6 < a && a < b + 1e-6)
 
+class collector : public set_visitor {
+ public:
+  virtual bool operator()(const elem_t* elems, size_t size) {
+    this->sets.push_back(set<elem_t>(elems, elems + size));
+    return true;
+  }
+
+  vector<set<elem_t> > sets;
+};
+
+// Linear congruential generator with its own state.
+class lcg {
+ public:
+  explicit lcg(uint64_t seed) : x_(seed) {}
+
+  double operator()() {
+    this->x_ = this->x_ * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (this->x_ >> 11) * (1.0 / 9007199254740992.0);
+  }
+
+ private:
+  uint64_t x_;
+};
+
 class TestSetset {
  public:
   void run() {
@@ -104,6 +129,7 @@ class TestSetset {
     this->lookup();
     this->modifiers();
     this->probability();
+    this->frozen();
     this->io();
     this->large();
   }
@@ -133,6 +159,12 @@ class TestSetset {
     ss = setset(V("{{}, {1,2}, {1,3}}"));
     assert(ss.zdd_ == s0 + s12 + s13);
 
+    ss = setset(V("{{2,3}, {1,2,3}, {3}, {1,2}, {2,3}, {1}, {}, {1,2,3}}"));
+    assert(ss.zdd_ == s0 + s1 + s3 + s12 + s23 + s123);
+
+    ss = setset(vector<set<int> >());
+    assert(ss.zdd_ == graphillion::bot());
+
     map<string, vector<int> > m;
     ss = setset(m);
     assert(ss.zdd_ == s0 + s1 + s2 + s3 + s12 + s13 + s23 + s123);
@@ -182,6 +214,25 @@ class TestSetset {
     assert(ss.smaller(3).zdd_ == s0 + s1 + s12 + s14 + s4);
     assert(ss.larger(3).zdd_ == s1234);
     assert(ss.set_size(3).zdd_ == s123 + s134);
+    assert(ss.set_size(0).zdd_ == s0);
+    assert(ss.set_size(5).zdd_ == graphillion::bot());
+
+    vector<string> hist = ss.size_histogram();
+    assert(hist.size() == 5);
+    assert(hist[0] == "1" && hist[1] == "2" && hist[2] == "2" &&
+           hist[3] == "2" && hist[4] == "1");
+    assert(setset().size_histogram().empty());
+
+    vector<double> w;
+    w.push_back(0);  // 1-offset
+    w.push_back(3);
+    w.push_back(-2);
+    w.push_back(-2);
+    w.push_back(4);
+    assert(ss.weight_range(w, 0, 3).zdd_ == s0 + s1 + s12 + s1234);
+    assert(ss.weight_range(w, 4, 4).zdd_ == s4);
+    assert(ss.weight_range(w, -10, 10) == ss);
+    assert(ss.weight_range(w, 8, 10).zdd_ == bot());
 
     ss = setset(V("{{1,2}, {1,2,3}, {2,3,4}}"));
     assert(ss.minimal().zdd_ == s12 + s234);
@@ -189,6 +240,11 @@ class TestSetset {
 
     ss = setset(V("{{1,2}, {1,4}, {2,3}, {3,4}}"));
     assert(ss.hitting().zdd_ == s123 + s1234 + s124 + s13 + s134 + s234 + s24);
+
+    ss = setset(V("{{1}, {3}}"));
+    assert(ss.hitting().zdd_ == s13 + s123 + s134 + s1234);
+    ss = setset(V("{{}, {2}}"));
+    assert(ss.hitting().zdd_ == graphillion::bot());
   }
 
   void binary_operators() {
@@ -227,6 +283,20 @@ class TestSetset {
     ss ^= setset(v);
     assert(ss.zdd_ == s0 + s1 + s123 + s1234 + s134 + s23 + s34 + s4);
 
+    setset w(V("{{}, {1}, {1,2}, {2,3}, {4}}"));
+    ss = setset(u) ^ w;
+    assert(ss.zdd_ == (setset(u).zdd_ - w.zdd_) + (w.zdd_ - setset(u).zdd_));
+    assert((w ^ w).zdd_ == bot());
+    assert((w ^ setset()) == w);
+    ss = setset(u).intersection_difference(setset(v), w);
+    assert(ss == ((setset(u) & setset(v)) - w));
+    assert(ss.zdd_ == s14);
+    ss = setset(u).union_intersection(setset(v), w);
+    assert(ss == ((setset(u) | setset(v)) & w));
+    assert(ss.zdd_ == s0 + s1 + s12 + s23 + s4);
+    assert(setset(u).intersection_difference(setset(u), setset()) == setset(u));
+    assert(setset().union_intersection(setset(v), w) == (setset(v) & w));
+
     v = V("{{1,2}}");
     ss = setset(u) / setset(v);
     assert(ss.zdd_ == s0 + s3 + s34);
@@ -246,9 +316,15 @@ class TestSetset {
     ss = setset(u).join(setset(v));
     assert(ss.zdd_ == s12 + s123 + s124 + s1234 + s134 + s14 + s23 + s234 + s34);
 
+    ss = setset(u).join(setset(v), 4, 2);
+    assert(ss.zdd_ == s12 + s123 + s124 + s1234 + s134 + s14 + s23 + s234 + s34);
+
     ss = setset(u).meet(setset(v));
     assert(ss.zdd_ == s0 + s1 + s12 + s14 + s2 + s23 + s3 + s34 + s4);
 
+    ss = setset(u).meet(setset(v), 4, 2);
+    assert(ss.zdd_ == s0 + s1 + s12 + s14 + s2 + s23 + s3 + s34 + s4);
+
     v = V("{{1,2}, {1,4}, {2,3}, {3,4}}");
     ss = setset(u).subsets(setset(v));
     assert(ss.zdd_ == s0 + s1 + s12 + s14 + s4);
@@ -305,6 +381,24 @@ class TestSetset {
     assert(ss == setset(v));
 
     ss = setset(V("{{}, {1}, {1,2}, {1,2,3}, {1,2,3,4}, {1,3,4}, {1,4}, {4}}"));
+    v.clear();
+    for (setset::iterator s = ss.begin(); s != ss.end(); ++s)
+      v.push_back(*s);
+    assert(v.size() == 8);
+    vector<elem_t> stack;
+    for (size_t i = 0; i < v.size(); ++i) {
+      assert(choose(ss.zdd_, &stack));
+      assert(v[i] == set<elem_t>(stack.begin(), stack.end()));
+    }
+
+    setset::iterator i = ss.find(S("{1,3,4}"));
+    assert(*i == S("{1,3,4}"));
+    assert(*++i == S("{1,4}"));
+    assert(*++i == S("{1}"));
+    assert(*++i == S("{4}"));
+    assert(*++i == S("{}"));
+    assert(++i == ss.end());
+
     vector<double> w;
     w.push_back(0);  // 1-offset
     w.push_back(.3);
@@ -339,6 +433,23 @@ class TestSetset {
 
     assert(ss.count(S("{1,2}")) == 1);
     assert(ss.count(S("{2,3}")) == 0);
+    assert(ss.count(S("{1}")) == 0);
+    assert(ss.count(S("{}")) == 1);
+    assert(ss.count(S("{1,2,3}")) == 0);
+
+    vector<set<int> > v;
+    v.push_back(S("{1,3}"));
+    v.push_back(S("{2}"));
+    v.push_back(S("{1,2,3}"));
+    v.push_back(S("{1}"));
+    v.push_back(S("{1,2}"));
+    v.push_back(S("{}"));
+    v.push_back(S("{1,3}"));
+    vector<bool> found = ss.contains(v);
+    assert(found.size() == 7);
+    assert(found[0] && !found[1] && !found[2] && !found[3] && found[4] &&
+           found[5] && found[6]);
+    assert(setset().contains(v) == vector<bool>(7, false));
   }
 
   void modifiers() {
@@ -395,6 +506,15 @@ class TestSetset {
     ss = setset(u);
     ss.flip();
     assert(ss.zdd_ == s0 + s123 + s1234 + s2 + s23 + s234 + s34 + s4);
+
+    // elements beyond num_elems() are out of the universe
+    setset::num_elems(3);
+    ss = setset(V("{{}, {1}, {1,2}}"));
+    assert((~ss).zdd_ == s2 + s3 + s13 + s23 + s123);
+    ss.flip();
+    assert(ss.zdd_ == s123 + s23 + s3);
+    assert((~setset()).zdd_ == s0 + s1 + s2 + s3 + s12 + s13 + s23 + s123);
+    setset::num_elems(4);
   }
 
   void probability() {
@@ -427,6 +547,55 @@ class TestSetset {
     assert_almost_equal(ss.probability(p), .4728);
   }
 
+  void frozen() {
+    frozen_setset fs;
+    assert(fs.empty());
+    assert(fs.size() == "0");
+    assert(!fs.contains(S("{}")));
+
+    fs = frozen_setset(setset(V("{{}}")));
+    assert(!fs.empty());
+    assert(fs.size() == "1");
+    assert(fs.contains(S("{}")));
+    assert(!fs.contains(S("{1}")));
+    assert(fs.random_set(rand_xor128).empty());
+
+    setset ss(V("{{}, {1}, {2}, {1,2}, {1,3}, {1,2,3,4}}"));
+    fs = frozen_setset(ss);
+    assert(fs.size() == "6");
+    assert(fs.num_elems() == 4);
+    for (setset::iterator i = ss.begin(); i != setset::end(); ++i)
+      assert(fs.contains(*i));
+    assert(!fs.contains(S("{3}")));
+    assert(!fs.contains(S("{1,2,3}")));
+    assert(!fs.contains(S("{1,4}")));
+
+    for (int i = 0; i < 100; ++i)
+      assert(ss.find(fs.random_set(rand_xor128)) != setset::end());
+    lcg g1(1), g2(1);
+    for (int i = 0; i < 100; ++i) {
+      set<elem_t> s = fs.random_set(g1);
+      assert(ss.find(s) != setset::end());
+      assert(fs.random_set(g2) == s);  // depends only on the generator
+    }
+
+    vector<double> w;
+    w.push_back(0);  // 1-offset
+    w.push_back(1);
+    w.push_back(-2);
+    w.push_back(3);
+    w.push_back(-1);
+    assert(fs.best_set(w) == S("{1,3}"));
+    assert(fs.best_set(w) == *ss.begin_from_max(w));
+
+    vector<double> m = fs.marginals();
+    assert(m.size() == 5);
+    assert_almost_equal(m[1], 4.0 / 6);
+    assert_almost_equal(m[2], 3.0 / 6);
+    assert_almost_equal(m[3], 2.0 / 6);
+    assert_almost_equal(m[4], 1.0 / 6);
+  }
+
   void io() {
     stringstream sstr;
     setset ss;
@@ -481,6 +650,68 @@ class TestSetset {
     ss = setset::load(fp);
     fclose(fp);
     assert(ss == setset(v));
+
+    sstr.clear(); sstr.str("");
+    ss.dump(sstr, true);
+    string bin = sstr.str();
+    assert(bin.size() > 4 && bin.substr(1, 3) == "ZDD");
+    ss = setset::load(sstr);
+    assert(sstr.good());
+    assert(ss == setset(v));
+
+    fp = fopen("/tmp/graphillion_", "w");
+    ss.dump(fp, true);
+    setset().dump(fp, true);
+    setset(V("{{}}")).dump(fp, true);
+    fclose(fp);
+    fp = fopen("/tmp/graphillion_", "r");
+    assert(setset::load(fp) == setset(v));
+    assert(setset::load(fp) == setset());
+    assert(setset::load(fp) == setset(V("{{}}")));
+    fclose(fp);
+
+    sstr.clear(); sstr.str("");
+    dump_binary(ss.zdd_, sstr, false);
+    assert(sstr.str().size() == bin.size() - 4);
+    assert(load(sstr) == ss.zdd_);
+
+    bin[bin.size() / 2] ^= 1;  // corrupted
+    sstr.clear(); sstr.str(bin);
+    assert(load(sstr) == null());
+    assert(!sstr.good());
+    sstr.clear(); sstr.str(bin.substr(0, bin.size() - 1));  // truncated
+    assert(load(sstr) == null());
+
+    sstr.clear(); sstr.str("");
+    ss._enum(sstr);
+    assert(sstr.str() == "{{1, 2, 3, 4}, {1, 2, 3}, {1, 2}, {1, 3, 4}, {1, 4}, "
+                         "{1}, {4}, {}}");
+
+    collector c;
+    assert(ss.visit(&c) == 8);
+    assert(setset(c.sets) == setset(v));
+    c.sets.clear();
+    assert(ss.visit(&c, 3, 2) == 2);
+    assert(c.sets.size() == 2 && c.sets[0] == S("1,3,4") &&
+           c.sets[1] == S("1,4"));
+    c.sets.clear();
+    assert(ss.visit(&c, 6) == 2);
+    assert(c.sets.size() == 2 && c.sets[0] == S("4") && c.sets[1] == S(""));
+    c.sets.clear();
+    assert(ss.visit(&c, 8) == 0);
+    assert(c.sets.empty());
+
+    fp = fopen("/tmp/graphillion_", "wb");
+    assert(ss.write_sets(fp, 1, 3) == 3);
+    fclose(fp);
+    fp = fopen("/tmp/graphillion_", "rb");
+    elem_t buf[16];
+    size_t n = fread(buf, sizeof(elem_t), 16, fp);
+    fclose(fp);
+    elem_t expected[] = {3, 1, 2, 3, 2, 1, 2, 3, 1, 3, 4};
+    assert(n == sizeof(expected) / sizeof(expected[0]));
+    for (size_t i = 0; i < n; ++i)
+      assert(buf[i] == expected[i]);
   }
 
   void large() {
@@ -490,9 +721,48 @@ class TestSetset {
     setset ss = setset(m) - setset(V("{{1}, {1,2}}"));
     assert(ss.size() == "10715086071862673209484250490600018105614048117055336074437503883703510511249361224931983788156958581275946729175531468251871452856923140435984577574698574803934567774824230985421074605062371141877954182153046474983581941267398767559165543946077062914571196477686542167660429831652624386837205668069374");
 
+    vector<string> hist = ss.size_histogram();
+    assert(hist.size() == 1001);
+    assert(hist[0] == "1" && hist[1] == "999" && hist[2] == "499499" &&
+           hist[999] == "1000" && hist[1000] == "1");
+    assert(hist[500] == "270288240945436569515614693625975275496152008446548287007392875106625428705522193898612483924502370165362606085021546104802209750050679917549894219699518475423665484263751733356162464079737887344364574161119497604571044985756287880514600994219426752366915856603136862602484428109296905863799821216320");
+
     int i = 0;
     for (setset::const_iterator s = ss.begin(); s != ss.end(); ++s)
       if (++i > 100) break;
+
+    // more levels than the kernel's recursion limit
+    n = 9000;
+    setset::num_elems(n);
+    setset all = setset(m);
+    ss = setset(V("{{1}, {1,2}}"));
+    assert((~ss | ss) == all);
+    assert((~ss & ss).empty());
+    setset tt = ss;
+    tt.flip();
+    assert(tt.size() == "2");
+    size_t k = 0;
+    for (setset::const_iterator s = tt.begin(); s != tt.end(); ++s)
+      k += (*s).size();
+    assert(k == static_cast<size_t>((n - 1) + (n - 2)));
+
+    // the expected families are disjoint unions, which stay shallow
+    map<string, vector<int> > m1, m2, m3;
+    m1["include"].push_back(1);
+    m2["include"].push_back(n);
+    m2["exclude"].push_back(1);
+    ss = setset(V("{{1, 9000}}"));
+    assert(ss.hitting() == (setset(m1) | setset(m2)));
+
+    m1["include"].push_back(2);
+    m2["include"].push_back(1);
+    m2["exclude"].clear();
+    m2["exclude"].push_back(2);
+    m3["include"].push_back(2);
+    m3["include"].push_back(4500);
+    m3["exclude"].push_back(1);
+    ss = setset(V("{{1, 2}, {1, 4500}, {2, 9000}}"));
+    assert(ss.hitting() == (setset(m1) | setset(m2) | setset(m3)));
   }
 };
 